@@ -0,0 +1,396 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+// Container benchmarks compared against std equivalents
+// * Build with optimizations, allocation columns need ASTD_TRACK_MEMORY
+// * Only SMemory allocations are counted, so std containers always show zero
+// * Example: g++ -std=c++17 -O2 -DBUILD_RELEASE=1 -DASTD_TRACK_MEMORY=1 -I../include ContainerBenchmarks.cpp -pthread -o ContainerBenchmarks
+
+#include "ASTD/ASTD.h"
+
+// TODO: Replace with custom implementation
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+static constexpr int32 ELEMENTS_NUM = 1024;
+
+// TArray
+/////////////////////////////////
+
+static void BenchmarkArray()
+{
+	SBenchmark::Print(SBenchmark::Run(TEXT("TArray<int32>::Add x1024"), []() {
+		TArray<int32> arr;
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) arr.Add(i);
+		SBenchmark::DoNotOptimize(arr.GetData());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::vector<int32>::push_back x1024"), []() {
+		std::vector<int32> arr;
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) arr.push_back(i);
+		SBenchmark::DoNotOptimize(arr.data());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("TArray<SString>::Add x1024"), []() {
+		TArray<SString> arr;
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) arr.Add(SString(TEXT("Benchmark string value")));
+		SBenchmark::DoNotOptimize(arr.GetData());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::vector<std::string>::push_back x1024"), []() {
+		std::vector<std::string> arr;
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) arr.push_back(std::string("Benchmark string value"));
+		SBenchmark::DoNotOptimize(arr.data());
+	}));
+
+	TArray<int32> source;
+	std::vector<int32> stdSource;
+	for (int32 i = 0; i < ELEMENTS_NUM; ++i)
+	{
+		source.Add(i);
+		stdSource.push_back(i);
+	}
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("TArray<int32>::Iterate x1024"), [&source]() {
+		int64 sum = 0;
+		for (const int32 val : source) sum += val;
+		SBenchmark::DoNotOptimize(sum);
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::vector<int32>::Iterate x1024"), [&stdSource]() {
+		int64 sum = 0;
+		for (const int32 val : stdSource) sum += val;
+		SBenchmark::DoNotOptimize(sum);
+	}));
+
+	// Last element is the worst case of linear search
+	SBenchmark::Print(SBenchmark::Run(TEXT("TArray<int32>::FindIndex x1024"), [&source]() {
+		SBenchmark::DoNotOptimize(source.FindIndex(ELEMENTS_NUM - 1));
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::find<int32> x1024"), [&stdSource]() {
+		SBenchmark::DoNotOptimize(std::find(stdSource.begin(), stdSource.end(), ELEMENTS_NUM - 1) - stdSource.begin());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("TArray<int32>::Append x1024"), [&source]() {
+		TArray<int32> arr;
+		arr.Append(source);
+		SBenchmark::DoNotOptimize(arr.GetData());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::vector<int32>::insert x1024"), [&stdSource]() {
+		std::vector<int32> arr;
+		arr.insert(arr.end(), stdSource.begin(), stdSource.end());
+		SBenchmark::DoNotOptimize(arr.data());
+	}));
+
+	// Copy is part of both measurements, removal from the middle moves half of the elements
+	SBenchmark::Print(SBenchmark::Run(TEXT("TArray<int32>::RemoveAt middle x64"), [&source]() {
+		TArray<int32> arr = source;
+		for (int32 i = 0; i < 64; ++i) arr.RemoveAt(arr.GetNum() / 2);
+		SBenchmark::DoNotOptimize(arr.GetData());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::vector<int32>::erase middle x64"), [&stdSource]() {
+		std::vector<int32> arr = stdSource;
+		for (int32 i = 0; i < 64; ++i) arr.erase(arr.begin() + arr.size() / 2);
+		SBenchmark::DoNotOptimize(arr.data());
+	}));
+}
+
+// TQueue
+/////////////////////////////////
+
+static void BenchmarkQueue()
+{
+	SBenchmark::Print(SBenchmark::Run(TEXT("TQueue<int32>::Enqueue/Dequeue x1024"), []() {
+		TQueue<int32> queue;
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) queue.Enqueue(i);
+
+		int32 val = 0;
+		while (queue.Dequeue(val)) SBenchmark::DoNotOptimize(val);
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::queue<int32>::push/pop x1024"), []() {
+		std::queue<int32> queue;
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) queue.push(i);
+
+		while (!queue.empty())
+		{
+			SBenchmark::DoNotOptimize(queue.front());
+			queue.pop();
+		}
+	}));
+}
+
+// SString
+/////////////////////////////////
+
+static void BenchmarkString()
+{
+	SBenchmark::Print(SBenchmark::Run(TEXT("SString::Construct"), []() {
+		SString str(TEXT("Benchmark string value"));
+		SBenchmark::DoNotOptimize(str.GetChars());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::string::Construct"), []() {
+		std::string str("Benchmark string value");
+		SBenchmark::DoNotOptimize(str.data());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("SString::operator+= x64"), []() {
+		const SString part(TEXT("part"));
+
+		SString str;
+		for (int32 i = 0; i < 64; ++i) str += part;
+		SBenchmark::DoNotOptimize(str.GetChars());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::string::operator+= x64"), []() {
+		const std::string part("part");
+
+		std::string str;
+		for (int32 i = 0; i < 64; ++i) str += part;
+		SBenchmark::DoNotOptimize(str.data());
+	}));
+
+	SString text;
+	std::string stdText;
+	for (int32 i = 0; i < 64; ++i)
+	{
+		text += TEXT("alpha,beta,gamma,");
+		stdText += "alpha,beta,gamma,";
+	}
+
+	text += TEXT("needle");
+	stdText += "needle";
+
+	const SString needle(TEXT("needle"));
+	SBenchmark::Print(SBenchmark::Run(TEXT("SString::Find 1KiB"), [&text, &needle]() {
+		SBenchmark::DoNotOptimize(text.Find(needle));
+	}));
+
+	const std::string stdNeedle("needle");
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::string::find 1KiB"), [&stdText, &stdNeedle]() {
+		SBenchmark::DoNotOptimize(stdText.find(stdNeedle));
+	}));
+
+	const SString delimiter(TEXT(","));
+	SBenchmark::Print(SBenchmark::Run(TEXT("SString::SplitToArray x193"), [&text, &delimiter]() {
+		TArray<SString> parts = text.SplitToArray(delimiter);
+		SBenchmark::DoNotOptimize(parts.GetData());
+	}));
+
+	// std has no split, this is the usual find/substr loop
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::string::find/substr x193"), [&stdText]() {
+		std::vector<std::string> parts;
+		std::string::size_type start = 0;
+		std::string::size_type end;
+		while ((end = stdText.find(',', start)) != std::string::npos)
+		{
+			if (end > start) parts.push_back(stdText.substr(start, end - start));
+			start = end + 1;
+		}
+
+		if (start < stdText.size()) parts.push_back(stdText.substr(start));
+		SBenchmark::DoNotOptimize(parts.data());
+	}));
+
+	const SString from(TEXT("beta"));
+	const SString to(TEXT("delta"));
+	SBenchmark::Print(SBenchmark::Run(TEXT("SString::Replace x64"), [&text, &from, &to]() {
+		SString result = text.Replace(from, to);
+		SBenchmark::DoNotOptimize(result.GetChars());
+	}));
+
+	// std has no replace all, this is the usual find/replace loop
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::string::find/replace x64"), [&stdText]() {
+		std::string result = stdText;
+		std::string::size_type pos = 0;
+		while ((pos = result.find("beta", pos)) != std::string::npos)
+		{
+			result.replace(pos, 4, "delta");
+			pos += 5;
+		}
+
+		SBenchmark::DoNotOptimize(result.data());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("SString::Printf"), []() {
+		SString str = SString::Printf(TEXT("Value %d of %s is %.2f"), 42, "benchmark", 3.25);
+		SBenchmark::DoNotOptimize(str.GetChars());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("snprintf + std::string"), []() {
+		char buffer[256];
+		snprintf(buffer, sizeof(buffer), "Value %d of %s is %.2f", 42, "benchmark", 3.25);
+		std::string str(buffer);
+		SBenchmark::DoNotOptimize(str.data());
+	}));
+}
+
+// TSharedPtr
+/////////////////////////////////
+
+static void BenchmarkShared()
+{
+	SBenchmark::Print(SBenchmark::Run(TEXT("MakeShared<int64>"), []() {
+		TSharedPtr<int64> ptr = MakeShared<int64>(1);
+		SBenchmark::DoNotOptimize(ptr.Get());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::make_shared<int64>"), []() {
+		std::shared_ptr<int64> ptr = std::make_shared<int64>(1);
+		SBenchmark::DoNotOptimize(ptr.get());
+	}));
+
+	const TSharedPtr<int64> sharedPtr = MakeShared<int64>(1);
+	SBenchmark::Print(SBenchmark::Run(TEXT("TSharedPtr<int64>::Copy"), [&sharedPtr]() {
+		TSharedPtr<int64> ptr = sharedPtr;
+		SBenchmark::DoNotOptimize(ptr.Get());
+	}));
+
+	const std::shared_ptr<int64> stdSharedPtr = std::make_shared<int64>(1);
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::shared_ptr<int64>::Copy"), [&stdSharedPtr]() {
+		std::shared_ptr<int64> ptr = stdSharedPtr;
+		SBenchmark::DoNotOptimize(ptr.get());
+	}));
+}
+
+// Archives
+/////////////////////////////////
+
+static void BenchmarkArchives()
+{
+	TArray<uint8> block;
+	block.AddUninitialized(64);
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("TArrayArchive::WriteBytes 64B x1024"), [&block]() {
+		TArrayArchive<uint8> ar(EArchiveType::Binary, EArchiveMode::Write);
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) ar.WriteBytes(block.GetData(), block.GetNum());
+		SBenchmark::DoNotOptimize(ar.GetData().GetData());
+	}));
+
+	TArray<uint8> span;
+	span.AddUninitialized(64 * ELEMENTS_NUM);
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("SSpanArchive::WriteBytes 64B x1024"), [&block, &span]() {
+		SSpanArchive ar(EArchiveType::Binary, EArchiveMode::Write, span.GetData(), span.GetNum());
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) ar.WriteBytes(block.GetData(), block.GetNum());
+		SBenchmark::DoNotOptimize(ar.GetData());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::vector<uint8>::insert 64B x1024"), [&block]() {
+		std::vector<uint8> data;
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) data.insert(data.end(), block.GetData(), block.GetData() + block.GetNum());
+		SBenchmark::DoNotOptimize(data.data());
+	}));
+}
+
+// File archives
+// * Every iteration opens, writes/reads 64 KiB and closes the file, so open/close cost is part of the measurement
+// * Files stay in page cache, numbers show archive overhead rather than storage speed
+/////////////////////////////////
+
+static constexpr const tchar* BENCHMARK_FILENAME = TEXT("ContainerBenchmarks.tmp");
+static constexpr const char* BENCHMARK_STD_FILENAME = "ContainerBenchmarks.tmp";
+
+static constexpr const tchar* BENCHMARK_COMPRESSED_FILENAME = TEXT("ContainerBenchmarks.alz.tmp");
+static constexpr const char* BENCHMARK_COMPRESSED_STD_FILENAME = "ContainerBenchmarks.alz.tmp";
+
+static void BenchmarkFileArchives()
+{
+	// Repeating pattern, so compressed archive has something to compress
+	TArray<uint8> block;
+	block.AddUninitialized(64);
+	for (int32 i = 0; i < block.GetNum(); ++i) block[i] = (uint8)(i % 16);
+
+	TArray<uint8> readBlock;
+	readBlock.AddUninitialized(64);
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("SBufferedFileArchive::WriteBytes 64B x1024"), [&block]() {
+		SBufferedFileArchive ar(EArchiveType::Binary, EArchiveMode::Write, BENCHMARK_FILENAME, true);
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) ar.WriteBytes(block.GetData(), block.GetNum());
+		ar.Flush();
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("SCFileArchive::WriteBytes 64B x1024"), [&block]() {
+		SCFileArchive ar(EArchiveType::Binary, EArchiveMode::Write, BENCHMARK_FILENAME, true);
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) ar.WriteBytes(block.GetData(), block.GetNum());
+		ar.Flush();
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("fwrite 64B x1024"), [&block]() {
+		FILE* file = fopen(BENCHMARK_STD_FILENAME, "wb");
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) fwrite(block.GetData(), 1, block.GetNum(), file);
+		fclose(file);
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::ofstream::write 64B x1024"), [&block]() {
+		std::ofstream file(BENCHMARK_STD_FILENAME, std::ios::binary | std::ios::trunc);
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) file.write((const char*)block.GetData(), block.GetNum());
+	}));
+
+	// Last write benchmark left the file with 64 KiB, every read benchmark reads it whole
+	SBenchmark::Print(SBenchmark::Run(TEXT("SBufferedFileArchive::ReadBytes 64B x1024"), [&readBlock]() {
+		SBufferedFileArchive ar(EArchiveType::Binary, EArchiveMode::Read, BENCHMARK_FILENAME, false);
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) ar.ReadBytes(readBlock.GetData(), readBlock.GetNum());
+		SBenchmark::DoNotOptimize(readBlock.GetData());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("SCFileArchive::ReadBytes 64B x1024"), [&readBlock]() {
+		SCFileArchive ar(EArchiveType::Binary, EArchiveMode::Read, BENCHMARK_FILENAME, false);
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) ar.ReadBytes(readBlock.GetData(), readBlock.GetNum());
+		SBenchmark::DoNotOptimize(readBlock.GetData());
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("fread 64B x1024"), [&readBlock]() {
+		FILE* file = fopen(BENCHMARK_STD_FILENAME, "rb");
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) SBenchmark::DoNotOptimize(fread(readBlock.GetData(), 1, readBlock.GetNum(), file));
+		fclose(file);
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("std::ifstream::read 64B x1024"), [&readBlock]() {
+		std::ifstream file(BENCHMARK_STD_FILENAME, std::ios::binary);
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) file.read((char*)readBlock.GetData(), readBlock.GetNum());
+		SBenchmark::DoNotOptimize(readBlock.GetData());
+	}));
+
+	// Compressed archive on top of buffered file, compare with the uncompressed buffered file and fwrite/fread above
+	SBenchmark::Print(SBenchmark::Run(TEXT("SCompressedArchive::WriteBytes 64B x1024"), [&block]() {
+		SBufferedFileArchive inner(EArchiveType::Binary, EArchiveMode::Write, BENCHMARK_COMPRESSED_FILENAME, true);
+		{
+			SCompressedArchive ar(inner);
+			for (int32 i = 0; i < ELEMENTS_NUM; ++i) ar.WriteBytes(block.GetData(), block.GetNum());
+		}
+		inner.Flush();
+	}));
+
+	SBenchmark::Print(SBenchmark::Run(TEXT("SCompressedArchive::ReadBytes 64B x1024"), [&readBlock]() {
+		SBufferedFileArchive inner(EArchiveType::Binary, EArchiveMode::Read, BENCHMARK_COMPRESSED_FILENAME, false);
+		SCompressedArchive ar(inner);
+		for (int32 i = 0; i < ELEMENTS_NUM; ++i) ar.ReadBytes(readBlock.GetData(), readBlock.GetNum());
+		SBenchmark::DoNotOptimize(readBlock.GetData());
+	}));
+
+	remove(BENCHMARK_STD_FILENAME);
+	remove(BENCHMARK_COMPRESSED_STD_FILENAME);
+}
+
+int main()
+{
+	SBenchmark::PrintHeader();
+
+	BenchmarkArray();
+	BenchmarkQueue();
+	BenchmarkString();
+	BenchmarkShared();
+	BenchmarkArchives();
+	BenchmarkFileArchives();
+
+	return 0;
+}
@@ -12,9 +12,17 @@
 #include "ASTD/ASTDMinimal.h"
 
 // UTILITIES
+#include "ASTD/Benchmark.h"
+#include "ASTD/Compression.h"
+#include "ASTD/Cpu.h"
+#include "ASTD/File.h"
+#include "ASTD/Log.h"
 #include "ASTD/Math.h"
+#include "ASTD/MemArena.h"
 #include "ASTD/Memory.h"
 #include "ASTD/Misc.h"
+#include "ASTD/Time.h"
+#include "ASTD/Trace.h"
 
 // CONTAINERS
 #include "ASTD/Array.h"
@@ -22,6 +30,7 @@
 #include "ASTD/Queue.h"
 
 // ALLOCATORS
+#include "ASTD/ArenaAllocator.h"
 #include "ASTD/ArrayAllocator.h"
 #include "ASTD/FixedArrayAllocator.h"
 #include "ASTD/QueueAllocator.h"
@@ -29,12 +38,24 @@
 // STRINGS
 #include "ASTD/CString.h"
 #include "ASTD/String.h"
+#include "ASTD/TextReader.h"
 
 // SHARED
+#include "ASTD/RefCount.h"
 #include "ASTD/Shared.h"
+#include "ASTD/UniquePtr.h"
 
 // EXTRAS -> ARCHIVE
 #include "ASTD/Archive.h"
+#include "ASTD/ArchiveStreamReader.h"
 #include "ASTD/ArrayArchive.h"
+#include "ASTD/AsyncFileArchive.h"
+#include "ASTD/AsyncStdoutArchive.h"
+#include "ASTD/BufferedFileArchive.h"
+#include "ASTD/CompressedArchive.h"
 #include "ASTD/FileArchive.h"
+#include "ASTD/FramedArchive.h"
+#include "ASTD/MappedFileArchive.h"
+#include "ASTD/SpanArchive.h"
 #include "ASTD/StdoutArchive.h"
+#include "ASTD/VarInt.h"
@@ -0,0 +1,29 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTD/Apple/AppleBuild.h"
+#include "ASTD/Apple/AppleFile.h"
+#include "ASTD/_internal/FileTypes.h"
+
+// Native asynchronous file queue is not implemented for this platform
+// * Init always fails, so caller falls back to its own implementation
+struct SApplePlatformAsyncFileQueue
+{
+	typedef SApplePlatformFile::HandleType HandleType;
+
+	FORCEINLINE bool IsInitialized() const { return false; }
+	FORCEINLINE uint32 GetDepth() const { return 0; }
+	FORCEINLINE uint32 GetPendingNum() const { return 0; }
+
+	FORCEINLINE bool Init(uint32) { return false; }
+	FORCEINLINE void Shutdown() {}
+
+	FORCEINLINE bool RegisterBuffers(const SFileSlice*, int32) { return false; }
+	FORCEINLINE bool UnregisterBuffers() { return false; }
+
+	FORCEINLINE bool Queue(HandleType, EAsyncFileOp, void*, uint32, int64, int32, uint64) { return false; }
+	FORCEINLINE int32 Submit() { return -1; }
+	FORCEINLINE int32 TakeBackPending(SAsyncFileCompletion*, int32) { return 0; }
+	FORCEINLINE int32 Reap(SAsyncFileCompletion*, int32, bool) { return 0; }
+};
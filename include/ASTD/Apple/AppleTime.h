@@ -0,0 +1,22 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include <ctime>
+
+#include "ASTD/Apple/AppleBuild.h"
+
+struct SApplePlatformTime
+{
+	// Gets monotonic time in nanoseconds, starting point is unspecified
+	FORCEINLINE static int64 GetMonotonicNanoseconds() { return (int64)clock_gettime_nsec_np(CLOCK_MONOTONIC_RAW); }
+
+	// Gets monotonic time in nanoseconds, cheap but with precision of few milliseconds
+	FORCEINLINE static int64 GetCoarseMonotonicNanoseconds() { return (int64)clock_gettime_nsec_np(CLOCK_MONOTONIC_RAW_APPROX); }
+
+	// Gets wall clock time in nanoseconds since epoch
+	FORCEINLINE static int64 GetWallNanoseconds() { return (int64)clock_gettime_nsec_np(CLOCK_REALTIME); }
+
+	// Gets wall clock time in nanoseconds since epoch, there is no cheaper variant on this platform
+	FORCEINLINE static int64 GetCoarseWallNanoseconds() { return (int64)clock_gettime_nsec_np(CLOCK_REALTIME); }
+};
@@ -4,7 +4,10 @@
 
 #include "ASTDMinimal.h"
 
+#include "ASTD/Array.h"
 #include "ASTD/CString.h"
+#include "ASTD/File.h"
+#include "ASTD/Math.h"
 
 enum class EArchiveType : uint8
 {
@@ -19,6 +22,19 @@ enum class EArchiveMode : uint8
 	ReadWrite
 };
 
+// Statistics of SArchive::TransferTo
+struct SArchiveTransferStats
+{
+	// Number of transferred bytes
+	int64 Bytes = 0;
+
+	// Number of bytes copied inside the kernel, without passing through user space
+	int64 NativeBytes = 0;
+
+	// Number of read/write (or kernel copy) calls
+	int32 Calls = 0;
+};
+
 struct SArchive
 {
 	// Types
@@ -26,6 +42,9 @@ struct SArchive
 
 	typedef int64 SizeType;
 
+	// Size of the buffer used when streaming data between archives
+	static constexpr SizeType TRANSFER_CHUNK_SIZE = 64 << 10; // 64 KiB
+
 	// Constructors
 	/////////////////////////
 
@@ -93,7 +112,7 @@ struct SArchive
 			const SizeType offsetBytes = GetBytesOffset();
 			const SizeType offsetElements = offsetBytes >= sizeof(T) ? offsetBytes / sizeof(T) : 0;
 
-			return GetOffset<T>() - offsetElements;
+			return GetTotal<T>() - offsetElements;
 		}
 	}
 
@@ -153,10 +172,85 @@ struct SArchive
 		return bytesWritten >= sizeof(T) ? bytesWritten / sizeof(T) : 0;
 	}
 
+	// Transfer
+	/////////////////////////
+
+	// Gets native file handle holding the archive data, SFile::INVALID_HANDLE when there is none
+	// * Archive offsets has to match file offsets and Flush has to put the handle in sync with archive state
+	virtual SFile::HandleType GetNativeHandle() const { return SFile::INVALID_HANDLE; }
+
+	// Streams bytes from current offset to other archive, negative size streams till the end
+	// * Uses kernel copy when both archives are backed by native files, otherwise goes through fixed size buffer
+	// * Returns number of transferred bytes
+	SizeType TransferTo(SArchive& other, SizeType size = INDEX_NONE, SArchiveTransferStats* outStats = nullptr)
+	{
+		SArchiveTransferStats stats;
+		if (!AllowsRead() || !other.AllowsWrite() || &other == this)
+		{
+			if (outStats) *outStats = stats;
+			return 0;
+		}
+
+		const SFile::HandleType fromHandle = GetNativeHandle();
+		const SFile::HandleType toHandle = other.GetNativeHandle();
+		if (SFile::IsValidHandle(fromHandle) && SFile::IsValidHandle(toHandle))
+		{
+			// Both sides have to be in sync with their files
+			Flush();
+			other.Flush();
+
+			const SizeType fromOffset = GetBytesOffset();
+			const SizeType toOffset = other.GetBytesOffset();
+			const SizeType nativeSize = size >= 0 ? size : GetTotalBytes() - fromOffset;
+
+			const int64 copied = nativeSize > 0 ? SFile::CopyRange(fromHandle, fromOffset, toHandle, toOffset, nativeSize) : -1;
+			if (copied > 0)
+			{
+				// Other archive has to pick up new file size before moving past it
+				other.Flush();
+
+				SetBytesOffset(fromOffset + copied);
+				other.SetBytesOffset(toOffset + copied);
+
+				stats.Bytes += copied;
+				stats.NativeBytes += copied;
+				++stats.Calls;
+			}
+		}
+
+		// pooled buffer
+		thread_local uint8 buffer[TRANSFER_CHUNK_SIZE];
+
+		while (size < 0 || stats.Bytes < size)
+		{
+			const SizeType chunk = size < 0 ? TRANSFER_CHUNK_SIZE : SMath::Min(size - stats.Bytes, TRANSFER_CHUNK_SIZE);
+
+			const SizeType readBytes = ReadBytes(buffer, chunk);
+			if (readBytes <= 0)
+			{
+				break;
+			}
+
+			const SizeType writtenBytes = other.WriteBytes(buffer, readBytes);
+			stats.Bytes += SMath::Max<SizeType>(writtenBytes, 0);
+			stats.Calls += 2;
+
+			if (writtenBytes != readBytes)
+			{
+				break;
+			}
+		}
+
+		if (outStats) *outStats = stats;
+		return stats.Bytes;
+	}
+
 	// Packet
 	// * Packet is a bunch of bytes basically
 	/////////////////////////
 
+	// Reads archive packet by packet till func returns true or end is reached
+	// * Reads synchronously into stack buffer, see SArchiveStreamReader for variant that prefetches on background thread
 	// Func: (const void* packet, SizeType numOfBytes) -> bool
 	template<SizeType MaxPacketSize, typename FuncType>
 	bool ReadPacketsUntil(FuncType&& func)
@@ -164,10 +258,10 @@ struct SArchive
 		uint8 packet[MaxPacketSize];
 		while(true)
 		{
-			const SizeType readBytes = ReadBytes(&packet, MaxPacketSize);
+			const SizeType readBytes = ReadBytes(packet, MaxPacketSize);
 			if (readBytes > 0)
 			{
-				if (func((const void*)&packet, readBytes)) break;
+				if (func((const void*)packet, readBytes)) break;
 			}
 
 			if (readBytes < MaxPacketSize)
@@ -184,7 +278,7 @@ struct SArchive
 	FORCEINLINE_DEBUGGABLE bool ReadPacketsUntil(SizeType startOffset, FuncType&& func)
 	{
 		if (!SetBytesOffset(startOffset)) return false;
-		return ReadPacketsUntil<MaxPacketSize>(Forward(func));
+		return ReadPacketsUntil<MaxPacketSize>(Forward<FuncType>(func));
 	}
 
 	// Container
@@ -206,41 +300,58 @@ struct SArchive
 	}
 
 	// Reads string with defined memory pool
+	// * Reads in small chunks till predicate fails, only characters read past the string are seeked back
+	// * Pooled buffer grows with the string, so string is never truncated
+	// * See STextReader for parsing of many values in row
 	/////////////////////////
 
 	template<typename ArchiveT, typename PredT>
 	const tchar* ReadPooledStringByPred(ArchiveT& ar, PredT&& predicate)
 	{
-		if (!AllowsRead()) return nullptr;
-		else if (!IsString()) return nullptr;
-
-		// pooled pointer
-		thread_local tchar buffer[SCString::LARGE_BUFFER_SIZE];
-
-		const SizeType oldOffset = ar.template GetOffset<tchar>();
-		const SizeType expectedReadNum = SMath::Min<SizeType>(SCString::LARGE_BUFFER_SIZE, GetTotal<tchar>());
+		if (!ar.AllowsRead()) return nullptr;
+		else if (!ar.IsString()) return nullptr;
 
-		if (expectedReadNum <= 0) return nullptr;
+		constexpr SizeType CHUNK_NUM = 32;
 
-		// Copy to buffer
-		const SizeType readNum = ar.Read(&buffer, expectedReadNum);
+		// pooled buffer
+		thread_local TArray<tchar> buffer;
+		buffer.Reset();
 
-		uint16 usedNum = 0;
-		while(usedNum < readNum)
+		SizeType usedNum = 0;
+		while (true)
 		{
-			const tchar& character = buffer[usedNum];
-			if (!predicate(character))
+			const SizeType chunkNum = SMath::Min(CHUNK_NUM, ar.template GetRemainingOffset<tchar>());
+			if (chunkNum <= 0)
 			{
+				if (usedNum == 0) return nullptr;
 				break;
 			}
 
-			++usedNum;
+			buffer.AddUninitialized(chunkNum);
+			const SizeType readNum = ar.Read(buffer.GetData() + usedNum, chunkNum);
+
+			SizeType passedNum = 0;
+			while (passedNum < readNum && predicate(buffer[usedNum + passedNum]))
+			{
+				++passedNum;
+			}
+
+			usedNum += passedNum;
+			if (passedNum < chunkNum)
+			{
+				if (readNum > passedNum)
+				{
+					ar.template SetOffset<tchar>(ar.template GetOffset<tchar>() - (readNum - passedNum));
+				}
+
+				break;
+			}
 		}
 
-		ar.template SetOffset<tchar>(oldOffset + usedNum);
+		if (buffer.GetNum() <= usedNum) buffer.Add(CHAR_TERM);
+		else buffer[usedNum] = CHAR_TERM;
 
-		buffer[usedNum] = CHAR_TERM;
-		return buffer;
+		return buffer.GetData();
 	}
 
 private:
@@ -251,22 +362,10 @@ private:
 // Archive operator<< && operator>>
 ////////////////////////////////////////////
 
-static SArchive& operator<<(SArchive& ar, SArchive& otherAr)
+// Streams everything remaining in other archive, see SArchive::TransferTo
+FORCEINLINE_DEBUGGABLE static SArchive& operator<<(SArchive& ar, SArchive& otherAr)
 {
-	if (ar.GetMode() == otherAr.GetMode() && otherAr.AllowsRead())
-	{
-		const uint32 remainingBytes = (otherAr.GetTotalBytes() - otherAr.GetBytesOffset());
-		if (remainingBytes > 0)
-		{
-			uint8* buffer = SMemory::MallocTyped<uint8>(remainingBytes);
-			{
-				otherAr.ReadBytes(buffer, remainingBytes);
-				ar.WriteBytes(buffer, remainingBytes);
-			}
-			SMemory::Free(buffer);
-		}
-	}
-
+	otherAr.TransferTo(ar);
 	return ar;
 }
 
@@ -281,11 +380,11 @@ inline static typename TEnableIf<ContainerTT::IsContainer, SArchive&>::Type oper
 {
 	if constexpr (ContainerTT::InlineMemory)
 	{
-		ar.Write(container.Begin(), container.GetNum());
+		ar.Write(container.begin(), container.GetNum());
 	}
 	else
 	{
-		for (auto it = container.Begin(); it != container.End(); ++it)
+		for (auto it = container.begin(); it != container.end(); ++it)
 		{
 			ar << *it;
 		}
@@ -0,0 +1,242 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/Array.h"
+#include "ASTD/Math.h"
+#include "ASTD/Memory.h"
+
+// TODO: Replace with custom implementation
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct SArchiveStreamReaderSettings
+{
+	// Number of bytes read at once
+	SArchive::SizeType ChunkSize = 1 << 20; // 1 MiB
+
+	// Number of chunks in flight, 2 means double buffering
+	int32 NumBuffers = 2;
+};
+
+// Reads archive chunk by chunk on background thread
+// * While caller processes one chunk, following ones are being read
+// * Archive can not be used by anyone else till reader is destroyed
+struct SArchiveStreamReader
+{
+	typedef SArchive::SizeType SizeType;
+
+	FORCEINLINE explicit SArchiveStreamReader(SArchive& ar, const SArchiveStreamReaderSettings& settings = {})
+		: _ar(ar)
+		, _settings(settings)
+	{
+		StartImpl();
+	}
+
+	// Starts reading from provided offset
+	FORCEINLINE SArchiveStreamReader(SArchive& ar, SizeType startOffset, const SArchiveStreamReaderSettings& settings = {})
+		: _ar(ar)
+		, _settings(settings)
+	{
+		if (_ar.SetBytesOffset(startOffset))
+		{
+			StartImpl();
+		}
+	}
+
+	SArchiveStreamReader(const SArchiveStreamReader&) = delete;
+	SArchiveStreamReader& operator=(const SArchiveStreamReader&) = delete;
+
+	~SArchiveStreamReader()
+	{
+		StopImpl();
+
+		for (SBuffer& buffer : _buffers)
+		{
+			SMemory::Free(buffer.Data);
+		}
+	}
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE bool IsValid() const { return !!_thread; }
+	FORCEINLINE SizeType GetChunkSize() const { return _settings.ChunkSize; }
+
+	// Gets number of bytes passed to caller so far
+	FORCEINLINE SizeType GetConsumedBytes() const { return _consumedBytes; }
+
+	// Reading
+	/////////////////////////////////
+
+	// Gets next chunk, blocks till it is read
+	// * Chunk stays valid till next call
+	// * Returns false once the end of archive is reached
+	bool Next(const uint8*& outData, SizeType& outSize)
+	{
+		if (!IsValid())
+		{
+			return false;
+		}
+
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		if (_holdsBuffer)
+		{
+			// Returns previously handed chunk to the reader thread
+			_readIdx = (_readIdx + 1) % _buffers.GetNum();
+			--_filledNum;
+			_holdsBuffer = false;
+
+			_freeCondition.notify_one();
+		}
+
+		_filledCondition.wait(lock, [this]() { return _filledNum > 0 || _finished; });
+		if (_filledNum == 0)
+		{
+			return false;
+		}
+
+		const SBuffer& buffer = _buffers[_readIdx];
+		outData = buffer.Data;
+		outSize = buffer.Size;
+
+		_holdsBuffer = true;
+		_consumedBytes += buffer.Size;
+
+		return true;
+	}
+
+	// Calls func with every chunk till it returns true or end is reached
+	// Func: (const void* packet, SizeType numOfBytes) -> bool
+	template<typename FuncType>
+	bool ReadPacketsUntil(FuncType&& func)
+	{
+		if (!IsValid())
+		{
+			return false;
+		}
+
+		const uint8* data;
+		SizeType size;
+		while (Next(data, size))
+		{
+			if (func((const void*)data, size)) break;
+		}
+
+		return true;
+	}
+
+private:
+
+	struct SBuffer
+	{
+		uint8* Data = nullptr;
+		SizeType Size = 0;
+	};
+
+	void StartImpl()
+	{
+		if (!_ar.AllowsRead() || !_ar.IsValid())
+		{
+			return;
+		}
+
+		_settings.ChunkSize = SMath::Max<SizeType>(_settings.ChunkSize, 1);
+		_settings.NumBuffers = SMath::Max(_settings.NumBuffers, 1);
+
+		for (int32 i = 0; i < _settings.NumBuffers; ++i)
+		{
+			SBuffer& buffer = _buffers.AddDefaulted_GetRef();
+			buffer.Data = SMemory::MallocTyped<uint8>(_settings.ChunkSize);
+		}
+
+		_thread = new std::thread([this]() { ReaderLoopImpl(); });
+	}
+
+	void StopImpl()
+	{
+		if (!_thread)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopping = true;
+		}
+
+		_freeCondition.notify_one();
+		_thread->join();
+
+		delete _thread;
+		_thread = nullptr;
+	}
+
+	void ReaderLoopImpl()
+	{
+		int32 writeIdx = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_freeCondition.wait(lock, [this]() { return _stopping || _filledNum < _buffers.GetNum(); });
+
+				if (_stopping)
+				{
+					break;
+				}
+			}
+
+			// Buffer is not visible to consumer till it is marked as filled
+			SBuffer& buffer = _buffers[writeIdx];
+			buffer.Size = SMath::Max<SizeType>(_ar.ReadBytes(buffer.Data, _settings.ChunkSize), 0);
+
+			const bool isEnd = buffer.Size < _settings.ChunkSize;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (buffer.Size > 0)
+				{
+					++_filledNum;
+				}
+
+				_finished = isEnd;
+			}
+
+			_filledCondition.notify_one();
+			writeIdx = (writeIdx + 1) % _buffers.GetNum();
+
+			if (isEnd)
+			{
+				return;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_finished = true;
+		_filledCondition.notify_one();
+	}
+
+	SArchive& _ar;
+	SArchiveStreamReaderSettings _settings = {};
+
+	TArray<SBuffer> _buffers = {};
+	std::thread* _thread = nullptr;
+
+	// Consumer state
+	int32 _readIdx = 0;
+	bool _holdsBuffer = false;
+	SizeType _consumedBytes = 0;
+
+	// Shared state
+	std::mutex _mutex = {};
+	std::condition_variable _freeCondition = {};
+	std::condition_variable _filledCondition = {};
+	int32 _filledNum = 0;
+	bool _finished = false;
+	bool _stopping = false;
+};
@@ -0,0 +1,120 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/MemArena.h"
+#include "ASTD/QueueAllocator.h"
+
+// TArray allocator taking memory from SMemArena
+// * Arena is the current one (SMemArena::GetCurrent) at the time allocator is created, moving TArray moves the arena too
+// * Growing the last allocation of the arena happens in place
+// * Arena has to outlive the container, ex. TArray<int32, TArenaAllocator<int32>>
+template<typename ElementT>
+class TArenaAllocator
+{
+public:
+
+	// Types
+	/////////////////////////////////
+
+	typedef ElementT ElementType;
+	typedef int64 SizeType;
+
+	// Constructor
+	/////////////////////////////////
+
+	FORCEINLINE TArenaAllocator() : _arena(&SMemArena::GetCurrent()) {}
+
+	// Destructor
+	/////////////////////////////////
+
+	FORCEINLINE ~TArenaAllocator() { Release(); }
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE SMemArena& GetArena() const { return *_arena; }
+
+	// Arena can be changed only while nothing is allocated
+	FORCEINLINE void SetArena(SMemArena& arena)
+	{
+		CHECK_RET(!_data);
+		_arena = &arena;
+	}
+
+	// Gets/Sets allocated data
+	FORCEINLINE ElementType* GetData() const { return _data; }
+	FORCEINLINE void SetData(ElementType* data) { _data = data; }
+
+	// Gets/Sets allocated count
+	FORCEINLINE SizeType GetSize() const { return _size; }
+	FORCEINLINE void SetSize(SizeType count) { _size = count; }
+
+	// Manipulation
+	/////////////////////////////////
+
+	// Allocates new elements
+	// @param - how many of elements should be allocated
+	// @return - array of new elements
+	ElementType* Allocate(SizeType num)
+	{
+		if (num <= 0) return nullptr;
+
+		ElementType* newData = (ElementType*)_arena->Reallocate(
+			_data,
+			_size * sizeof(ElementType),
+			(_size + num) * sizeof(ElementType),
+			GetAlignmentImpl()
+		);
+
+		ElementType* elementPtr = newData + _size;
+
+		_data = newData;
+		_size += num;
+
+		return elementPtr;
+	}
+
+	// Releases resources, memory is reused only when it was the last allocation of the arena
+	void Release()
+	{
+		if(_data)
+		{
+			_arena->Free(_data, _size * sizeof(ElementType));
+
+			_data = nullptr;
+			_size = 0;
+		}
+	}
+
+private:
+
+	FORCEINLINE static constexpr int64 GetAlignmentImpl()
+	{
+		return alignof(ElementType) > SMemArena::DEFAULT_ALIGNMENT ? alignof(ElementType) : SMemArena::DEFAULT_ALIGNMENT;
+	}
+
+	SMemArena* _arena = nullptr;
+	ElementType* _data = nullptr;
+	SizeType _size = 0;
+};
+
+// Node memory of TQueueAllocator taken from SMemArena
+// * Arena is the current one (SMemArena::GetCurrent) at the time allocator is created
+struct SQueueArenaMemory
+{
+	FORCEINLINE SQueueArenaMemory() : _arena(&SMemArena::GetCurrent()) {}
+
+	FORCEINLINE void* Malloc(int64 size) { return _arena->Allocate(size); }
+	FORCEINLINE void Free(void* ptr, int64 size) { _arena->Free(ptr, size); }
+
+private:
+
+	SMemArena* _arena = nullptr;
+};
+
+// TQueue allocator taking memory from SMemArena, ex. TQueue<int32, TArenaQueueAllocator<int32>>
+template<typename ElementT>
+using TArenaQueueAllocator = TQueueAllocator<ElementT, SQueueArenaMemory>;
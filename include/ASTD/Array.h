@@ -9,6 +9,19 @@
 
 #include "ASTD/ArrayAllocator.h"
 
+namespace NArrayInternals
+{
+	// Allocators taking memory from arena (ex. TArenaAllocator), arena has to move together with the data
+	GENERATE_HAS_METHOD_TRAIT(THasArenaMethod, GetArena())
+
+	// Heap allocator with any alignment, memory is a single block owned by the array
+	template<typename AllocatorT>
+	struct TIsArrayAllocator { enum { Value = false }; };
+
+	template<typename ElementT, uint32 Alignment>
+	struct TIsArrayAllocator<TArrayAllocator<ElementT, Alignment>> { enum { Value = true }; };
+}
+
 template<typename ElementT, typename AllocatorT>
 class TArray
 {
@@ -57,21 +70,21 @@ public:
 	// Destructor
 	/////////////////////////////////
 
-	FORCEINLINE ~TArray() { EmptyImpl(true); }
+	FORCEINLINE ~TArray() { EmptyImpl(0); }
 
 	// Compare operators
 	/////////////////////////////////
 
-	FORCEINLINE bool operator==(const TArray& other) const { return CompareAllocatorsPrivate(&_allocator, &other._allocator, _num); }
-	FORCEINLINE bool operator!=(const TArray& other) const { return CompareAllocatorsPrivate(&_allocator, &other._allocator, _num); }
+	FORCEINLINE bool operator==(const TArray& other) const { return _num == other._num && CompareAllocatorsPrivate(&_allocator, &other._allocator, _num); }
+	FORCEINLINE bool operator!=(const TArray& other) const { return !operator==(other); }
 
 	// Assign operators
 	/////////////////////////////////
 
-	FORCEINLINE TArray& operator=(const TArray& other) { EmptyImpl(true); AppendImpl(other); return *this; }
+	FORCEINLINE TArray& operator=(const TArray& other) { if (&other != this) { Reset(); AppendImpl(other); } return *this; }
 	FORCEINLINE TArray& operator=(TArray&& other) noexcept { ReplaceImpl(Move(other)); return *this; }
 
-	FORCEINLINE TArray& operator=(const ElementListType& list) { EmptyImpl(true); AppendImpl(list.begin(), list.size()); return *this; }
+	FORCEINLINE TArray& operator=(const ElementListType& list) { Reset(); AppendImpl(list.begin(), list.size()); return *this; }
 
 	// Get operators
 	/////////////////////////////////
@@ -122,7 +135,7 @@ public:
 
 	FORCEINLINE void Add(ElementT&& val)
 	{
-		AppendImpl(&val, 1, true);
+		Emplace(Move(val));
 	}
 
 	FORCEINLINE void AddDefaulted(SizeType num = 1)
@@ -143,8 +156,7 @@ public:
 
 	FORCEINLINE ElementT& Add_GetRef(ElementT&& val)
 	{
-		AppendImpl(&val, 1, true);
-		return *GetElementAtImpl(_num - 1);
+		return Emplace_GetRef(Move(val));
 	}
 
 	FORCEINLINE ElementT& AddDefaulted_GetRef()
@@ -159,8 +171,8 @@ public:
 		return *GetElementAtImpl(_num - 1);
 	}
 
-	FORCEINLINE void Push(const ElementT& val) { AddImpl(val); }
-	FORCEINLINE void Push(ElementT&& val) { AddImpl(Move(val)); }
+	FORCEINLINE void Push(const ElementT& val) { Add(val); }
+	FORCEINLINE void Push(ElementT&& val) { Add(Move(val)); }
 
 	// Add
 	/////////////////////////////////
@@ -414,14 +426,20 @@ public:
 
 private:
 
+	// Malloc alignment is enough for most of the types
+	static constexpr bool IsOverAligned = alignof(ElementT) > SMemory::DEFAULT_ALIGNMENT;
+
+	// Bytes of elements swapped through stack buffer
+	static constexpr int64 SWAP_STACK_SIZE = 256;
+
 	FORCEINLINE ElementT* GetElementAtImpl(SizeType idx) const { return _allocator.GetData() + idx; }
 
 	void AddDefaultedImpl(SizeType num = 1)
 	{
 		if(num <= 0) return;
 
+		GrowIfNeededImpl(_num + num);
 		_num += num;
-		GrowIfNeededImpl();
 
 		SMemory::ZeroTyped(GetElementAtImpl(_num - num), num);
 	}
@@ -430,8 +448,8 @@ private:
 	{
 		if(num <= 0) return;
 
+		GrowIfNeededImpl(_num + num);
 		_num += num;
-		GrowIfNeededImpl();
 	}
 
 	void RemoveSwapImpl(SizeType idx)
@@ -441,10 +459,9 @@ private:
 		if(idx != _num - 1)
 		{
 			// Swaps last element with this
-			SMemory::Move(
+			SMemory::RelocateTyped(
 				GetElementAtImpl(idx),
-				GetElementAtImpl(_num - 1),
-				sizeof(ElementT)
+				GetElementAtImpl(_num - 1)
 			);
 		}
 
@@ -461,10 +478,10 @@ private:
 
 			// NOTE(jan.kristian.fisera):
 			// * Is it worth to cache start index and try to move from start in case that would be fewer iterations ?
-			SMemory::Move(
+			SMemory::RelocateTyped(
 				GetElementAtImpl(idx),
 				GetElementAtImpl(idx + 1),
-				sizeof(ElementT) * (_num - idx - 1)
+				_num - idx - 1
 			);
 		}
 
@@ -473,30 +490,45 @@ private:
 
 	void SwapImpl(SizeType firstIdx, SizeType secondIdx, SizeType num)
 	{
-		// Copy to temporary storage
-		AllocatorT tmp;
-		tmp.Allocate(num);
-		SMemory::CopyTyped(
-			tmp.GetData(),
+		// Relocate to temporary storage
+		// * Small ranges use stack, heap goes through aligned allocation only for over-aligned elements
+		alignas(ElementT) uint8 stackBuffer[sizeof(ElementT) > SWAP_STACK_SIZE ? sizeof(ElementT) : SWAP_STACK_SIZE];
+		const bool isHeap = num * (SizeType)sizeof(ElementT) > (SizeType)sizeof(stackBuffer);
+
+		ElementT* tmp = (ElementT*)stackBuffer;
+		if (isHeap)
+		{
+			if constexpr (IsOverAligned) tmp = SMemory::MallocAlignedTyped<ElementT>(num);
+			else tmp = SMemory::MallocTyped<ElementT>(num);
+		}
+
+		SMemory::RelocateTyped(
+			tmp,
 			GetElementAtImpl(firstIdx),
-			sizeof(ElementT) * num
+			num
 		);
 
 		// Do swap to first index
 		// * elements from second idx to first
-		SMemory::CopyTyped(
+		SMemory::RelocateTyped(
 			GetElementAtImpl(firstIdx),
 			GetElementAtImpl(secondIdx),
-			sizeof(ElementT) * num
+			num
 		);
 
 		// Do swap to second index
-		// * copied elements from first idx to second
-		SMemory::CopyTyped(
+		// * relocated elements from first idx to second
+		SMemory::RelocateTyped(
 			GetElementAtImpl(secondIdx),
-			tmp.GetData(),
-			sizeof(ElementT) * num
+			tmp,
+			num
 		);
+
+		if (isHeap)
+		{
+			if constexpr (IsOverAligned) SMemory::FreeAligned(tmp);
+			else SMemory::Free(tmp);
+		}
 	}
 
 	void ShrinkImpl(SizeType num)
@@ -514,37 +546,47 @@ private:
 			_num = num;
 		}
 
-		// Copy to temporary allocator
-		AllocatorT tmp;
-		tmp.Allocate(num);
-		SMemory::CopyTyped(
-			tmp.GetData(),
-			_allocator.GetData(),
-			num
-		);
+		ReallocateImpl(num);
+	}
 
-		// Move data back to main allocator
-		_allocator.Release();
-		_allocator.Allocate(num);
-		SMemory::CopyTyped(
+	// Relocates elements into new allocation of exactly "num" elements
+	void ReallocateImpl(SizeType num)
+	{
+		AllocatorT newAllocator;
+		if constexpr (NArrayInternals::THasArenaMethod<AllocatorT>::Value)
+		{
+			// New allocation comes from the same arena, not the current one
+			newAllocator.SetArena(_allocator.GetArena());
+		}
+
+		newAllocator.Allocate(num);
+		SMemory::RelocateTyped(
+			newAllocator.GetData(),
 			_allocator.GetData(),
-			tmp.GetData(),
-			num
+			_num
 		);
 
-		tmp.SetData(nullptr);
-		tmp.SetSize(0);
+		_allocator.Release();
+		MoveAllocatorPrivate(_allocator, newAllocator);
 	}
 
 	FORCEINLINE void GrowImpl(SizeType num)
 	{
+		GrowIfNeededImpl(num);
 		_num = num;
-		GrowIfNeededImpl();
 	}
 
 	FORCEINLINE void ReserveImpl(SizeType num)
 	{
-		_allocator.Allocate(num - _allocator.GetSize());
+		if constexpr (TIsBitwiseRelocatable<ElementT>::Value)
+		{
+			// Allocator can realloc, elements do not care about their address
+			_allocator.Allocate(num - _allocator.GetSize());
+		}
+		else if (num > _allocator.GetSize())
+		{
+			ReallocateImpl(num);
+		}
 	}
 
 	void EmptyImpl(SizeType newNum)
@@ -576,34 +618,21 @@ private:
 	{
 		if(num > 0)
 		{
-			const SizeType oldCount = _num;
-
+			GrowIfNeededImpl(_num + num);
+			SMemory::CopyTyped(_allocator.GetData() + _num, data, num);
 			_num += num;
-			GrowIfNeededImpl();
-			SMemory::CopyTyped(_allocator.GetData() + oldCount, data, num);
 		}
 	}
 
-	void AppendImpl(ElementT* data, SizeType num, bool preferMove)
+	void AppendImpl(TArray&& other)
 	{
-		if(preferMove && _num == 1)
+		if(other._num > 0)
 		{
-			const SizeType oldCount = _num;
-
-			_num += num;
-			GrowIfNeededImpl();
-
-			SMemory::MoveTyped(_allocator.GetData() + oldCount, data);
+			GrowIfNeededImpl(_num + other._num);
+			SMemory::RelocateTyped(_allocator.GetData() + _num, other.GetData(), other._num);
+			_num += other._num;
 		}
-		else
-		{
-			AppendImpl(data, num);
-		}
-	}
 
-	void AppendImpl(TArray&& other)
-	{
-		AppendImpl(other.GetData(), other._num, true);
 		other._allocator.Release();
 		other._num = 0;
 	}
@@ -612,14 +641,12 @@ private:
 
 	void ReplaceImpl(TArray&& other)
 	{
-		EmptyImpl(true);
+		if (&other == this) return;
 
-		_allocator.SetData(other._allocator.GetData());
-		_allocator.SetSize(other._allocator.GetSize());
-		_num = other._num;
+		EmptyImpl(0);
 
-		other._allocator.SetData(nullptr);
-		other._allocator.SetSize(0);
+		MoveAllocatorPrivate(_allocator, other._allocator);
+		_num = other._num;
 		other._num = 0;
 	}
 
@@ -639,12 +666,13 @@ private:
 		}
 	}
 
-	void GrowIfNeededImpl()
+	// Has to be called before "_num" is increased, only constructed elements are relocated
+	void GrowIfNeededImpl(SizeType num)
 	{
 		const SizeType reserved = _allocator.GetSize();
-		if(_num > reserved)
+		if(num > reserved)
 		{
-			ReserveImpl(SMath::CeilToPowerOfTwo((uint64)_num));
+			ReserveImpl(SMath::CeilToPowerOfTwo((uint64)num));
 		}
 	}
 
@@ -657,6 +685,21 @@ private:
 		}
 	}
 
+	// Moves allocated data into released allocator, arena allocators take the arena as well
+	FORCEINLINE static void MoveAllocatorPrivate(AllocatorT& to, AllocatorT& from)
+	{
+		if constexpr (NArrayInternals::THasArenaMethod<AllocatorT>::Value)
+		{
+			to.SetArena(from.GetArena());
+		}
+
+		to.SetData(from.GetData());
+		to.SetSize(from.GetSize());
+
+		from.SetData(nullptr);
+		from.SetSize(0);
+	}
+
 	FORCEINLINE static bool CompareAllocatorsPrivate(const AllocatorT* lhs, const AllocatorT* rhs, SizeType size)
 	{
 		return (lhs->GetSize() >= size && rhs->GetSize() >= size) ?
@@ -677,6 +720,10 @@ struct TContainerTypeTraits<TArray<ElementT, AllocatorT>> : public TContainerTyp
 	{
 		IsContainer = true,
 		IsDynamic = true,
-		InlineMemory = TIsSame<AllocatorT, TArrayAllocator<ElementT>>::Value
+		InlineMemory = NArrayInternals::TIsArrayAllocator<AllocatorT>::Value
 	};
 };
+
+// Elements live on the heap, so array itself can be relocated
+template<typename ElementT, typename AllocatorT>
+struct TIsBitwiseRelocatable<TArray<ElementT, AllocatorT>> { enum { Value = true }; };
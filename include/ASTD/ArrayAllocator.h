@@ -8,7 +8,9 @@
 
 // Main allocator used by TArray
 // * Has data inlined
-template<typename ElementT>
+// * Data is aligned at least to "Alignment" (0 = alignment of the element), over-aligned element types are always aligned properly
+// * Example: TArray<float, TArrayAllocator<float, 32>> for AVX data
+template<typename ElementT, uint32 Alignment>
 class TArrayAllocator
 {
 public:
@@ -19,6 +21,10 @@ public:
 	typedef ElementT ElementType;
 	typedef int64 SizeType;
 
+	static constexpr int64 ALIGNMENT = Alignment > alignof(ElementT) ? Alignment : alignof(ElementT);
+
+	static_assert((ALIGNMENT & (ALIGNMENT - 1)) == 0, "Alignment has to be power of two");
+
 	// Constructor
 	/////////////////////////////////
 
@@ -51,9 +57,19 @@ public:
 	{
 		if (num <= 0) return nullptr;
 
-		ElementType* newData = _data
-			? SMemory::ReallocTyped<ElementType>(_data, _size + num)
-			: SMemory::MallocTyped<ElementType>(_size + num);
+		ElementType* newData;
+		if constexpr (!IsOverAligned)
+		{
+			newData = _data
+				? SMemory::ReallocTyped<ElementType>(_data, _size + num)
+				: SMemory::MallocTyped<ElementType>(_size + num);
+		}
+		else
+		{
+			newData = _data
+				? SMemory::ReallocAlignedTyped<ElementType>(_data, _size + num, ALIGNMENT)
+				: SMemory::MallocAlignedTyped<ElementType>(_size + num, ALIGNMENT);
+		}
 
 		ElementType* elementPtr = newData + _size;
 
@@ -68,7 +84,8 @@ public:
 	{
 		if(_data)
 		{
-			SMemory::Free(_data);
+			if constexpr (!IsOverAligned) SMemory::Free(_data);
+			else SMemory::FreeAligned(_data);
 
 			_data = nullptr;
 			_size = 0;
@@ -77,6 +94,9 @@ public:
 
 private:
 
+	// Malloc alignment is enough for most of the types
+	static constexpr bool IsOverAligned = ALIGNMENT > SMemory::DEFAULT_ALIGNMENT;
+
 	ElementType* _data = nullptr;
 	SizeType _size = 0;
 };
@@ -7,9 +7,10 @@
 #include "ASTD/Archive.h"
 #include "ASTD/Array.h"
 
-// TODO(krisfis): we might want to in-place memory, meaning that it will write to memory block provided
-// Also setting read/write mode is annoying, maybe make it optional
-template<typename ElementT, typename AllocatorT = typename TArray<tchar>::AllocatorType>
+// Archive that owns growable array
+// * See SSpanArchive for archive over caller provided memory block
+// TODO(krisfis): Setting read/write mode is annoying, maybe make it optional
+template<typename ElementT, typename AllocatorT = typename TArray<ElementT>::AllocatorType>
 struct TArrayArchive : public SArchive
 {
 	typedef TArray<ElementT, AllocatorT> ArrayType;
@@ -24,15 +25,26 @@ struct TArrayArchive : public SArchive
 	FORCEINLINE TArrayArchive(EArchiveType type, EArchiveMode mode, ArrayType&& data)
 		: SArchive(type, mode)
 	{
-		SetData(Forward(data));
+		SetData(Move(data));
 	}
 
 	// Data set/get
 	/////////////////////////////////
 
-	FORCEINLINE void SetData(ArrayType&& data) { _data = data; _offset = _data.GetNum(); }
+	FORCEINLINE void SetData(ArrayType&& data) { _data = Move(data); _offset = _data.GetNum(); }
 	FORCEINLINE const ArrayType& GetData() const { return _data; }
 
+	// Moves data out of the archive, archive is left empty
+	FORCEINLINE ArrayType ReleaseData()
+	{
+		ArrayType data = Move(_data);
+		_offset = 0;
+		return data;
+	}
+
+	// Reserves space for "num" elements, so following writes do not reallocate
+	FORCEINLINE void Reserve(SizeType num) { if (num > _data.GetReservedNum()) _data.Reserve(num); }
+
 	// SArchive overrides
 	/////////////////////////////////
 
@@ -42,8 +54,8 @@ struct TArrayArchive : public SArchive
 	FORCEINLINE virtual SizeType GetBytesOffset() const override { return _offset * ELEMENT_SIZE; }
 	virtual bool SetBytesOffset(SizeType offset) override
 	{
-		const SizeType offsetInElements = offset >= ELEMENT_SIZE ? SMath::Floor(offset / ELEMENT_SIZE) : 0;
-		if (_data.IsValidIndex(offsetInElements))
+		const SizeType offsetInElements = offset >= ELEMENT_SIZE ? offset / ELEMENT_SIZE : 0;
+		if (offset >= 0 && offsetInElements <= _data.GetNum())
 		{
 			_offset = offsetInElements;
 			return true;
@@ -58,13 +70,13 @@ struct TArrayArchive : public SArchive
 		else if (!AllowsRead()) return 0;
 
 		const SizeType elementsToRead = SMath::Min<SizeType>(
-			SMath::Floor(size / ELEMENT_SIZE),
+			size / ELEMENT_SIZE,
 			_data.GetNum() - _offset
 		);
 
 		if (elementsToRead > 0)
 		{
-			SMemory::Copy(ptr, _data.GetData() + (_offset * ELEMENT_SIZE), elementsToRead * ELEMENT_SIZE);
+			SMemory::Copy(ptr, _data.GetData() + _offset, elementsToRead * ELEMENT_SIZE);
 			_offset += elementsToRead;
 		}
 
@@ -76,13 +88,14 @@ struct TArrayArchive : public SArchive
 		if (!ptr || size < ELEMENT_SIZE) return 0;
 		else if (!AllowsWrite()) return 0;
 
-		const SizeType elementsToWrite = SMath::Floor(size / ELEMENT_SIZE);
+		const SizeType elementsToWrite = size / ELEMENT_SIZE;
 		if (elementsToWrite + _offset > _data.GetNum())
 		{
-			_data.Resize(elementsToWrite + _offset);
+			// Array grows geometrically, so appending is amortized
+			_data.AppendUninitialized(elementsToWrite + _offset - _data.GetNum());
 		}
 
-		SMemory::Copy(_data.GetData() + (_offset * ELEMENT_SIZE), ptr, size);
+		SMemory::Copy(_data.GetData() + _offset, ptr, elementsToWrite * ELEMENT_SIZE);
 		_offset += elementsToWrite;
 
 		return elementsToWrite * ELEMENT_SIZE;
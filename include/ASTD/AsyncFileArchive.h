@@ -0,0 +1,548 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/Array.h"
+#include "ASTD/File.h"
+#include "ASTD/Math.h"
+#include "ASTD/Queue.h"
+
+// TODO: Replace with custom implementation
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include PLATFORM_HEADER(AsyncFile)
+
+typedef PLATFORM_PREFIXED_TYPE(S, PlatformAsyncFileQueue) SPlatformAsyncFileQueue;
+
+struct SAsyncFileArchiveSettings
+{
+	// Number of operations that can be in flight at once
+	uint32 QueueDepth = 64;
+
+	// Number of threads used when native queue is not available
+	int32 NumFallbackWorkers = 2;
+
+	// Opens file with EFileOpenFlags::Direct
+	// * Operations with buffer, size or offset not aligned to DIRECT_ALIGNMENT are rejected
+	bool Direct = false;
+
+	// Skips native queue, mostly for testing
+	bool ForceFallback = false;
+};
+
+// Handle of single asynchronous operation
+// * Has to stay alive (and at the same address) till operation completes
+struct SAsyncFileRequest
+{
+	typedef int64 SizeType;
+
+	FORCEINLINE SAsyncFileRequest() = default;
+
+	SAsyncFileRequest(const SAsyncFileRequest&) = delete;
+	SAsyncFileRequest& operator=(const SAsyncFileRequest&) = delete;
+
+	FORCEINLINE bool IsIdle() const { return _state.load(std::memory_order_acquire) == STATE_IDLE; }
+	FORCEINLINE bool IsPending() const { return _state.load(std::memory_order_acquire) == STATE_PENDING; }
+	FORCEINLINE bool IsComplete() const { return _state.load(std::memory_order_acquire) == STATE_COMPLETED; }
+
+	// Gets number of processed bytes or negative error code, valid once completed
+	FORCEINLINE int64 GetResult() const { return _result; }
+
+private:
+	friend struct SAsyncFileArchive;
+
+	static constexpr uint8 STATE_IDLE = 0;
+	static constexpr uint8 STATE_PENDING = 1;
+	static constexpr uint8 STATE_COMPLETED = 2;
+
+	std::atomic<uint8> _state = { STATE_IDLE };
+	int64 _result = 0;
+
+	// Operation description, used by fallback workers
+	EAsyncFileOp _op = EAsyncFileOp::Read;
+	void* _data = nullptr;
+	SizeType _size = 0;
+	SizeType _offset = 0;
+};
+
+// File archive with asynchronous operations
+// * Uses native queue (io_uring on Linux) when available, otherwise falls back to a pool of worker threads
+// * Operations are batched, nothing is passed for processing till Submit (or any Wait) is called
+// * SArchive interface is synchronous, implemented as submit & wait
+struct SAsyncFileArchive : public SArchive
+{
+	typedef SFile::HandleType HandleType;
+
+	// Largest request processed by single operation
+	static constexpr SizeType MAX_REQUEST_SIZE = 1 << 30; // 1 GiB
+
+	// Alignment of buffers, sizes and offsets required by direct operations
+	static constexpr SizeType DIRECT_ALIGNMENT = 4096;
+
+	SAsyncFileArchive(EArchiveType type, EArchiveMode mode, const tchar* filename, bool overwrite, const SAsyncFileArchiveSettings& settings = {})
+		: SArchive(type, mode)
+		, _settings(settings)
+	{
+		OpenImpl(filename, overwrite);
+	}
+
+	virtual ~SAsyncFileArchive() override
+	{
+		CloseImpl();
+	}
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE HandleType GetHandle() const { return _handle; }
+
+	// Whether operations are processed by native queue (not by fallback workers)
+	FORCEINLINE bool IsNative() const { return _queue.IsInitialized(); }
+
+	// Gets number of operations queued or processed
+	FORCEINLINE int32 GetInFlightNum() const { return _inFlightNum.load(std::memory_order_acquire); }
+
+	// Asynchronous operations
+	/////////////////////////////////
+
+	// Registers buffers for faster processing, use index of the buffer when queueing operation
+	// * Fallback ignores registration, operations with buffer index still work
+	FORCEINLINE bool RegisterBuffers(const SFileSlice* buffers, int32 num) { return IsNative() ? _queue.RegisterBuffers(buffers, num) : true; }
+	FORCEINLINE bool UnregisterBuffers() { return IsNative() ? _queue.UnregisterBuffers() : true; }
+
+	// Queues read of "size" bytes from "offset"
+	// * bufferIndex is index of registered buffer containing ptr or INDEX_NONE
+	FORCEINLINE bool ReadAsync(SAsyncFileRequest& request, void* ptr, SizeType size, SizeType offset, int32 bufferIndex = INDEX_NONE)
+	{
+		if (!AllowsRead()) return false;
+		return QueueImpl(request, EAsyncFileOp::Read, ptr, size, offset, bufferIndex);
+	}
+
+	// Queues write of "size" bytes to "offset"
+	// * bufferIndex is index of registered buffer containing ptr or INDEX_NONE
+	FORCEINLINE bool WriteAsync(SAsyncFileRequest& request, const void* ptr, SizeType size, SizeType offset, int32 bufferIndex = INDEX_NONE)
+	{
+		if (!AllowsWrite()) return false;
+		if (!QueueImpl(request, EAsyncFileOp::Write, const_cast<void*>(ptr), size, offset, bufferIndex)) return false;
+
+		_fileSize = SMath::Max(_fileSize, offset + size);
+		return true;
+	}
+
+	// Passes all queued operations for processing
+	// * returns number of submitted operations or negative error code
+	// * When native queue refuses operations, they are completed with the error code
+	int32 Submit()
+	{
+		if (IsNative())
+		{
+			const int32 result = _queue.Submit();
+			if (result < 0)
+			{
+				FailPendingImpl(result);
+			}
+
+			return result;
+		}
+
+		const int32 num = (int32)_batch.GetNum();
+		if (num > 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				for (SAsyncFileRequest* request : _batch)
+				{
+					_work.Enqueue(request);
+				}
+			}
+
+			_batch.Empty(num);
+			_workCondition.notify_all();
+		}
+
+		return num;
+	}
+
+	// Processes finished operations without blocking
+	FORCEINLINE void Poll() { if (IsNative()) ReapImpl(false); }
+
+	// Waits till provided operation finishes, submits queued operations if needed
+	// * returns result of the operation or negative error code when waiting failed (operation stays pending)
+	int64 Wait(SAsyncFileRequest& request)
+	{
+		if (request.IsIdle()) return 0;
+
+		Submit();
+
+		if (IsNative())
+		{
+			while (!request.IsComplete())
+			{
+				ResubmitImpl();
+				if (request.IsComplete())
+				{
+					break;
+				}
+
+				const int32 result = ReapImpl(true);
+				if (result < 0)
+				{
+					return result;
+				}
+			}
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_doneCondition.wait(lock, [&request]() { return request.IsComplete(); });
+		}
+
+		return request.GetResult();
+	}
+
+	// Waits till all operations finish
+	// * returns false when waiting failed, some operations may still be pending
+	bool WaitAll()
+	{
+		Submit();
+
+		if (IsNative())
+		{
+			while (GetInFlightNum() > 0)
+			{
+				ResubmitImpl();
+				if (GetInFlightNum() == 0)
+				{
+					break;
+				}
+
+				if (ReapImpl(true) < 0)
+				{
+					return false;
+				}
+			}
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_doneCondition.wait(lock, [this]() { return GetInFlightNum() == 0; });
+		}
+
+		return true;
+	}
+
+	// SArchive overrides
+	/////////////////////////////////
+
+	FORCEINLINE virtual bool IsValid() const override { return SFile::IsValidHandle(_handle); }
+	FORCEINLINE virtual SFile::HandleType GetNativeHandle() const override { return _handle; }
+
+	// Waits for all operations and resyncs cached size with the file
+	virtual void Flush() override
+	{
+		if (!IsValid()) return;
+
+		WaitAll();
+
+		const SizeType fileSize = SFile::GetSize(_handle);
+		if (fileSize >= 0)
+		{
+			_fileSize = fileSize;
+		}
+	}
+
+	FORCEINLINE virtual SizeType GetTotalBytes() const override { return _fileSize; }
+	FORCEINLINE virtual SizeType GetBytesOffset() const override { return _offset; }
+
+	FORCEINLINE virtual bool SetBytesOffset(SizeType offset) override
+	{
+		if (offset < 0) return false;
+
+		_offset = offset;
+		return true;
+	}
+
+	virtual SizeType ReadBytes(void* ptr, SizeType size) override
+	{
+		if (!ptr || size <= 0 || !IsValid()) return 0;
+
+		const SizeType processed = ProcessSyncImpl(EAsyncFileOp::Read, ptr, size);
+		_offset += processed;
+		return processed;
+	}
+
+	virtual SizeType WriteBytes(const void* ptr, SizeType size) override
+	{
+		if (!ptr || size <= 0 || !IsValid()) return 0;
+
+		const SizeType processed = ProcessSyncImpl(EAsyncFileOp::Write, const_cast<void*>(ptr), size);
+		_offset += processed;
+		return processed;
+	}
+
+private:
+
+	void OpenImpl(const tchar* filename, bool overwrite)
+	{
+		uint32 flags = EFileOpenFlags::None;
+		switch (GetMode())
+		{
+			case EArchiveMode::Read:
+				flags = EFileOpenFlags::Read;
+			break;
+			case EArchiveMode::Write:
+				flags = EFileOpenFlags::Write | EFileOpenFlags::Create | EFileOpenFlags::Truncate;
+			break;
+			case EArchiveMode::ReadWrite:
+				flags = EFileOpenFlags::Read | EFileOpenFlags::Write | EFileOpenFlags::Create;
+				if (overwrite) flags |= EFileOpenFlags::Truncate;
+			break;
+		}
+
+		if (_settings.Direct)
+		{
+			flags |= EFileOpenFlags::Direct;
+		}
+
+		_handle = SFile::Open(filename, flags);
+		if (!IsValid())
+		{
+			return;
+		}
+
+		_fileSize = SMath::Max<SizeType>(SFile::GetSize(_handle), 0);
+
+		const uint32 depth = SMath::Max<uint32>(_settings.QueueDepth, 1);
+		if (_settings.ForceFallback || !_queue.Init(depth))
+		{
+			const int32 workersNum = SMath::Max(_settings.NumFallbackWorkers, 1);
+			for (int32 i = 0; i < workersNum; ++i)
+			{
+				_workers.Add(new std::thread([this]() { WorkerLoopImpl(); }));
+			}
+		}
+	}
+
+	void CloseImpl()
+	{
+		if (IsValid())
+		{
+			WaitAll();
+		}
+
+		if (!_workers.IsEmpty())
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stopping = true;
+			}
+
+			_workCondition.notify_all();
+			for (std::thread* worker : _workers)
+			{
+				worker->join();
+				delete worker;
+			}
+
+			_workers.Empty();
+		}
+
+		_queue.Shutdown();
+
+		if (IsValid())
+		{
+			SFile::Close(_handle);
+			_handle = SFile::INVALID_HANDLE;
+		}
+	}
+
+	bool QueueImpl(SAsyncFileRequest& request, EAsyncFileOp op, void* ptr, SizeType size, SizeType offset, int32 bufferIndex)
+	{
+		if (!ptr || size <= 0 || size > MAX_REQUEST_SIZE || offset < 0) return false;
+		else if (!IsValid() || request.IsPending()) return false;
+		else if (_settings.Direct && !IsDirectAlignedImpl(ptr, size, offset)) return false;
+
+		request._op = op;
+		request._data = ptr;
+		request._size = size;
+		request._offset = offset;
+		request._result = 0;
+		request._state.store(SAsyncFileRequest::STATE_PENDING, std::memory_order_release);
+
+		if (IsNative())
+		{
+			// Keeps number of operations in flight within completion queue capacity
+			while (GetInFlightNum() >= (int32)_queue.GetDepth())
+			{
+				Submit();
+				if (GetInFlightNum() > 0 && ReapImpl(true) < 0)
+				{
+					request._state.store(SAsyncFileRequest::STATE_IDLE, std::memory_order_release);
+					return false;
+				}
+			}
+
+			if (!_queue.Queue(_handle, op, ptr, (uint32)size, offset, bufferIndex, (uint64)&request))
+			{
+				// Submission queue is full, kernel consumes it on submit
+				Submit();
+				if (!_queue.Queue(_handle, op, ptr, (uint32)size, offset, bufferIndex, (uint64)&request))
+				{
+					request._state.store(SAsyncFileRequest::STATE_IDLE, std::memory_order_release);
+					return false;
+				}
+			}
+		}
+		else
+		{
+			_batch.Add(&request);
+		}
+
+		_inFlightNum.fetch_add(1, std::memory_order_acq_rel);
+		return true;
+	}
+
+	// Returns number of completed operations or negative error code
+	int32 ReapImpl(bool wait)
+	{
+		SAsyncFileCompletion completions[32];
+
+		const int32 num = _queue.Reap(completions, 32, wait);
+		for (int32 i = 0; i < num; ++i)
+		{
+			SAsyncFileRequest* request = (SAsyncFileRequest*)completions[i].UserData;
+			CompleteImpl(*request, completions[i].Result);
+		}
+
+		return num;
+	}
+
+	// Submits operations kernel did not consume on the previous submit (ex. it stopped at bad operation)
+	// * When kernel takes none of them, they are failed instead of being waited for forever
+	void ResubmitImpl()
+	{
+		if (_queue.GetPendingNum() == 0)
+		{
+			return;
+		}
+
+		const int32 result = _queue.Submit();
+		if (result <= 0)
+		{
+			FailPendingImpl(result < 0 ? result : -EAGAIN);
+		}
+	}
+
+	// Completes operations kernel did not take, so nobody waits for them forever
+	void FailPendingImpl(int32 error)
+	{
+		SAsyncFileCompletion completions[32];
+
+		int32 num;
+		while ((num = _queue.TakeBackPending(completions, 32)) > 0)
+		{
+			for (int32 i = 0; i < num; ++i)
+			{
+				CompleteImpl(*(SAsyncFileRequest*)completions[i].UserData, error);
+			}
+		}
+	}
+
+	FORCEINLINE static bool IsDirectAlignedImpl(const void* ptr, SizeType size, SizeType offset)
+	{
+		return (((uint64)ptr | (uint64)size | (uint64)offset) & (DIRECT_ALIGNMENT - 1)) == 0;
+	}
+
+	FORCEINLINE void CompleteImpl(SAsyncFileRequest& request, int64 result)
+	{
+		request._result = result;
+		request._state.store(SAsyncFileRequest::STATE_COMPLETED, std::memory_order_release);
+		_inFlightNum.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	SizeType ProcessSyncImpl(EAsyncFileOp op, void* ptr, SizeType size)
+	{
+		SizeType processed = 0;
+		while (processed < size)
+		{
+			const SizeType chunkSize = SMath::Min(size - processed, MAX_REQUEST_SIZE);
+
+			SAsyncFileRequest request;
+			const bool queued = (op == EAsyncFileOp::Read)
+				? ReadAsync(request, (uint8*)ptr + processed, chunkSize, _offset + processed)
+				: WriteAsync(request, (uint8*)ptr + processed, chunkSize, _offset + processed);
+
+			if (!queued)
+			{
+				break;
+			}
+
+			const int64 result = Wait(request);
+			if (result <= 0)
+			{
+				break;
+			}
+
+			processed += result;
+		}
+
+		return processed;
+	}
+
+	void WorkerLoopImpl()
+	{
+		while (true)
+		{
+			SAsyncFileRequest* request = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_workCondition.wait(lock, [this]() { return _stopping || !_work.IsEmpty(); });
+
+				if (!_work.Dequeue(request))
+				{
+					// Stopping and no work left
+					return;
+				}
+			}
+
+			const int64 result = (request->_op == EAsyncFileOp::Read)
+				? SFile::ReadAllAt(_handle, request->_data, request->_size, request->_offset)
+				: SFile::WriteAllAt(_handle, request->_data, request->_size, request->_offset);
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				CompleteImpl(*request, result);
+			}
+
+			_doneCondition.notify_all();
+		}
+	}
+
+	SAsyncFileArchiveSettings _settings = {};
+	HandleType _handle = SFile::INVALID_HANDLE;
+
+	SizeType _offset = 0;
+	SizeType _fileSize = 0;
+
+	std::atomic<int32> _inFlightNum = { 0 };
+
+	// Native queue
+	SPlatformAsyncFileQueue _queue = {};
+
+	// Fallback workers
+	TArray<SAsyncFileRequest*> _batch = {};
+	TQueue<SAsyncFileRequest*> _work = {};
+	TArray<std::thread*> _workers = {};
+
+	std::mutex _mutex = {};
+	std::condition_variable _workCondition = {};
+	std::condition_variable _doneCondition = {};
+	bool _stopping = false;
+};
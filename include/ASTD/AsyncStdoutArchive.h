@@ -0,0 +1,335 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/Math.h"
+#include "ASTD/Memory.h"
+#include "ASTD/Misc.h"
+
+// TODO: Replace with custom implementation
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// What happens with writes when buffer is full
+enum class EAsyncStdoutFullPolicy : uint8
+{
+	// Waits till flusher makes space
+	Block = 0,
+	// Discards the write, see GetDroppedBytes
+	Drop
+};
+
+struct SAsyncStdoutArchiveSettings
+{
+	// Size of the buffer shared by all writers
+	int64 BufferSize = 1 << 20; // 1 MiB
+
+	// Flusher is woken once this many bytes are pending
+	int64 FlushThreshold = 64 << 10; // 64 KiB
+
+	// Flusher writes pending data at least this often
+	int32 FlushIntervalMs = 50;
+
+	EAsyncStdoutFullPolicy FullPolicy = EAsyncStdoutFullPolicy::Block;
+};
+
+// Standard output archive that can be written from multiple threads without locking
+// * Writes are copied into shared ring buffer, background thread passes them to the file in batches (writev)
+// * Writes smaller than half of the buffer are never interleaved with other writes
+// * Flush blocks till everything written before it reaches the file
+template<int32 FileNo>
+struct TAsyncStdoutArchive : public SArchive
+{
+	static_assert(FileNo == SMisc::STDOUT_FILE_NO || FileNo == SMisc::STDERR_FILE_NO, "Unsupported std output file no");
+
+	explicit TAsyncStdoutArchive(const SAsyncStdoutArchiveSettings& settings = {})
+		: SArchive(EArchiveType::String, EArchiveMode::Write)
+		, _settings(settings)
+	{
+		int64 slotsNum = 2;
+		while (slotsNum * SLOT_SIZE < settings.BufferSize)
+		{
+			slotsNum <<= 1;
+		}
+
+		_slotsNum = slotsNum;
+		_data = SMemory::MallocTyped<uint8>(slotsNum * SLOT_SIZE);
+		_sizes = SMemory::MallocTyped<uint32>(slotsNum);
+		_sequences = SMemory::MallocTyped<std::atomic<uint64>>(slotsNum);
+
+		// Slot is free for position "pos" when its sequence equals "pos"
+		for (int64 i = 0; i < slotsNum; ++i)
+		{
+			new(&_sequences[i]) std::atomic<uint64>((uint64)i);
+		}
+
+		_thread = new std::thread([this]() { FlusherLoopImpl(); });
+	}
+
+	virtual ~TAsyncStdoutArchive() override
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopping = true;
+		}
+
+		_flushCondition.notify_one();
+		_thread->join();
+		delete _thread;
+
+		SMemory::Free(_sequences);
+		SMemory::Free(_sizes);
+		SMemory::Free(_data);
+	}
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE int32 GetFileNo() const { return FileNo; }
+	FORCEINLINE const SAsyncStdoutArchiveSettings& GetSettings() const { return _settings; }
+
+	// Gets number of bytes discarded because buffer was full (EAsyncStdoutFullPolicy::Drop)
+	FORCEINLINE int64 GetDroppedBytes() const { return _droppedBytes.load(std::memory_order_relaxed); }
+
+	// SArchive overrides
+	/////////////////////////////////
+
+	FORCEINLINE virtual bool IsValid() const override { return !!_data; }
+	FORCEINLINE virtual SizeType GetTotalBytes() const override { return _writtenBytes.load(std::memory_order_relaxed); }
+	FORCEINLINE virtual SizeType GetBytesOffset() const override { return _writtenBytes.load(std::memory_order_relaxed); }
+	FORCEINLINE virtual bool SetBytesOffset(SizeType) override { return false; }
+	FORCEINLINE virtual SizeType ReadBytes(void*, SizeType) override { return 0; }
+
+	virtual void Flush() override
+	{
+		const uint64 target = _head.load(std::memory_order_acquire);
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (_tail.load(std::memory_order_acquire) < target)
+		{
+			_flushRequested = true;
+			_flushCondition.notify_one();
+
+			// Timeout covers writers that reserved space but did not commit it yet
+			_flushedCondition.wait_for(lock, std::chrono::milliseconds(1));
+		}
+	}
+
+	virtual SizeType WriteBytes(const void* ptr, SizeType size) override
+	{
+		if (!ptr || size <= 0) return 0;
+
+		// Message can never take more than half of the buffer, so there is always progress
+		const SizeType maxMessageSize = (_slotsNum / 2) * SLOT_SIZE;
+
+		SizeType totalWrittenBytes = 0;
+		while (totalWrittenBytes < size)
+		{
+			const SizeType messageSize = SMath::Min(size - totalWrittenBytes, maxMessageSize);
+			if (!PushImpl((const uint8*)ptr + totalWrittenBytes, messageSize))
+			{
+				_droppedBytes.fetch_add(size - totalWrittenBytes, std::memory_order_relaxed);
+				break;
+			}
+
+			totalWrittenBytes += messageSize;
+		}
+
+		_writtenBytes.fetch_add(totalWrittenBytes, std::memory_order_relaxed);
+		return totalWrittenBytes;
+	}
+
+private:
+
+	static constexpr int64 SLOT_SIZE = 64;
+	static constexpr int32 MAX_BATCH_NUM = 64;
+
+	// Copies message into the buffer, returns false when it was dropped
+	bool PushImpl(const uint8* data, SizeType size)
+	{
+		const uint64 slotsNum = (uint64)((size + SLOT_SIZE - 1) / SLOT_SIZE);
+		const uint64 mask = (uint64)_slotsNum - 1;
+
+		uint64 pos = _head.load(std::memory_order_relaxed);
+		while (true)
+		{
+			// Slots are freed in order, so when the last one is free all of them are
+			const uint64 last = pos + slotsNum - 1;
+			const uint64 sequence = _sequences[last & mask].load(std::memory_order_acquire);
+
+			if (sequence == last)
+			{
+				if (_head.compare_exchange_weak(pos, pos + slotsNum, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (sequence < last)
+			{
+				// Buffer is full
+				if (_settings.FullPolicy == EAsyncStdoutFullPolicy::Drop)
+				{
+					return false;
+				}
+
+				WaitForSpaceImpl();
+				pos = _head.load(std::memory_order_relaxed);
+			}
+			else
+			{
+				pos = _head.load(std::memory_order_relaxed);
+			}
+		}
+
+		// Reserved slots are contiguous unless they wrap around the end
+		const uint64 startSlot = pos & mask;
+		const SizeType firstSize = SMath::Min<SizeType>(size, (_slotsNum - startSlot) * SLOT_SIZE);
+		SMemory::Copy(_data + startSlot * SLOT_SIZE, data, firstSize);
+		if (firstSize < size)
+		{
+			SMemory::Copy(_data, data + firstSize, size - firstSize);
+		}
+
+		_sizes[startSlot] = (uint32)size;
+
+		// Only the first slot marks message as committed, flusher never looks at the others
+		_sequences[startSlot].store(pos + 1, std::memory_order_release);
+
+		const int64 pendingBytes = _pendingBytes.fetch_add(size, std::memory_order_relaxed) + size;
+		if (pendingBytes >= _settings.FlushThreshold && !_thresholdNotified.exchange(true, std::memory_order_relaxed))
+		{
+			_flushCondition.notify_one();
+		}
+
+		return true;
+	}
+
+	void WaitForSpaceImpl()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		_flushRequested = true;
+		_flushCondition.notify_one();
+		_flushedCondition.wait_for(lock, std::chrono::milliseconds(1));
+	}
+
+	void FlusherLoopImpl()
+	{
+		while (true)
+		{
+			bool stopping;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_flushCondition.wait_for(lock, std::chrono::milliseconds(_settings.FlushIntervalMs), [this]() {
+					return _stopping || _flushRequested || _thresholdNotified.load(std::memory_order_relaxed);
+				});
+
+				stopping = _stopping;
+				_flushRequested = false;
+			}
+
+			_thresholdNotified.store(false, std::memory_order_relaxed);
+			DrainImpl();
+
+			_flushedCondition.notify_all();
+
+			if (stopping)
+			{
+				// Writers are gone, so every reserved message is committed by now
+				DrainImpl();
+				break;
+			}
+		}
+	}
+
+	// Writes all committed messages, stops at the first uncommitted one
+	void DrainImpl()
+	{
+		const uint64 mask = (uint64)_slotsNum - 1;
+
+		const void* buffers[MAX_BATCH_NUM];
+		uint64 sizes[MAX_BATCH_NUM];
+
+		uint64 tail = _tail.load(std::memory_order_relaxed);
+		while (true)
+		{
+			// Collects batch of committed messages
+			int32 buffersNum = 0;
+			uint64 batchEnd = tail;
+			int64 batchBytes = 0;
+			while (buffersNum + 2 <= MAX_BATCH_NUM)
+			{
+				const uint64 startSlot = batchEnd & mask;
+				if (_sequences[startSlot].load(std::memory_order_acquire) != batchEnd + 1)
+				{
+					break;
+				}
+
+				const uint64 size = _sizes[startSlot];
+				const uint64 firstSize = SMath::Min<uint64>(size, (_slotsNum - startSlot) * SLOT_SIZE);
+
+				buffers[buffersNum] = _data + startSlot * SLOT_SIZE;
+				sizes[buffersNum++] = firstSize;
+				if (firstSize < size)
+				{
+					buffers[buffersNum] = _data;
+					sizes[buffersNum++] = size - firstSize;
+				}
+
+				batchEnd += (size + SLOT_SIZE - 1) / SLOT_SIZE;
+				batchBytes += size;
+			}
+
+			if (buffersNum == 0)
+			{
+				break;
+			}
+
+			SMisc::WriteStdBuffers(FileNo, buffers, sizes, buffersNum);
+
+			for (uint64 pos = tail; pos < batchEnd; ++pos)
+			{
+				_sequences[pos & mask].store(pos + _slotsNum, std::memory_order_release);
+			}
+
+			_pendingBytes.fetch_sub(batchBytes, std::memory_order_relaxed);
+
+			tail = batchEnd;
+			_tail.store(tail, std::memory_order_release);
+		}
+	}
+
+	SAsyncStdoutArchiveSettings _settings = {};
+
+	// Ring of fixed size slots, message takes one or more consecutive slots
+	uint8* _data = nullptr;
+	uint32* _sizes = nullptr;
+	std::atomic<uint64>* _sequences = nullptr;
+	int64 _slotsNum = 0;
+
+	// Writers state
+	alignas(64) std::atomic<uint64> _head = { 0 };
+	std::atomic<int64> _pendingBytes = { 0 };
+	std::atomic<int64> _writtenBytes = { 0 };
+	std::atomic<int64> _droppedBytes = { 0 };
+	std::atomic<bool> _thresholdNotified = { false };
+
+	// Flusher state
+	alignas(64) std::atomic<uint64> _tail = { 0 };
+	std::thread* _thread = nullptr;
+
+	std::mutex _mutex = {};
+	std::condition_variable _flushCondition = {};
+	std::condition_variable _flushedCondition = {};
+	bool _flushRequested = false;
+	bool _stopping = false;
+};
+
+typedef TAsyncStdoutArchive<SMisc::STDOUT_FILE_NO> SAsyncStdoutArchive;
+typedef TAsyncStdoutArchive<SMisc::STDERR_FILE_NO> SAsyncStderrArchive;
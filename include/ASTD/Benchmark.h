@@ -0,0 +1,189 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Math.h"
+#include "ASTD/Memory.h"
+#include "ASTD/Misc.h"
+#include "ASTD/Time.h"
+
+// TODO: Replace with custom implementation
+#include <cstdio>
+
+#if COMPILER_MSVC
+	#include <intrin.h>
+#endif
+
+struct SBenchmarkSettings
+{
+	// Iterations are increased till single measured batch takes at least this long
+	int64 MinBatchNs = 50 * 1000 * 1000; // 50 ms
+
+	// Number of measured batches, the fastest one is reported
+	int32 BatchesNum = 5;
+
+	int64 MaxIterations = (int64)1 << 32;
+};
+
+struct SBenchmarkResult
+{
+	const tchar* Name = nullptr;
+
+	// Iterations of the reported batch
+	int64 Iterations = 0;
+
+	double NsPerOp = 0.0;
+
+	// Always zero unless ASTD_TRACK_MEMORY is enabled
+	double AllocationsPerOp = 0.0;
+	double BytesPerOp = 0.0;
+};
+
+// Microbenchmark harness
+// * Iterations are calibrated so timer overhead and resolution do not matter, then the fastest of multiple batches is reported
+// * Allocations are counted by SMemory tracker (ASTD_TRACK_MEMORY), memory not allocated through SMemory is not visible
+// * Results of benchmarked code have to be passed to DoNotOptimize, otherwise compiler may remove the code
+// * Example: SBenchmark::Print(SBenchmark::Run(TEXT("TArray::Add"), [&]() { arr.Add(1); }));
+struct SBenchmark
+{
+	// Optimization barriers
+	/////////////////////////////////
+
+	// Forces compiler to compute the value, its computation can not be removed
+	template<typename T>
+	FORCEINLINE static void DoNotOptimize(const T& value)
+	{
+#if COMPILER_MSVC
+		_ReadWriteBarrier();
+		volatile const void* escape = &value;
+		(void)escape;
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	// Forces compiler to assume that all memory was read and written
+	FORCEINLINE static void ClobberMemory()
+	{
+#if COMPILER_MSVC
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : : "memory");
+#endif
+	}
+
+	// Running
+	/////////////////////////////////
+
+	// Calls "func" once per iteration
+	template<typename FuncT>
+	static SBenchmarkResult Run(const tchar* name, FuncT&& func, const SBenchmarkSettings& settings = {})
+	{
+		return RunBatched(name, [&func](int64 iterations) {
+			for (int64 i = 0; i < iterations; ++i)
+			{
+				func();
+			}
+		}, settings);
+	}
+
+	// Calls "func" with number of iterations it has to do, so setup can be done outside of the loop
+	template<typename FuncT>
+	static SBenchmarkResult RunBatched(const tchar* name, FuncT&& func, const SBenchmarkSettings& settings = {})
+	{
+		SBenchmarkResult result;
+		result.Name = name;
+
+		// Calibration, estimated from the last batch so it takes only few steps
+		int64 iterations = 1;
+		while (true)
+		{
+			const int64 elapsedNs = MeasureImpl(func, iterations, nullptr);
+			if (elapsedNs >= settings.MinBatchNs || iterations >= settings.MaxIterations)
+			{
+				break;
+			}
+
+			const int64 estimated = elapsedNs > 0 ? (int64)((double)iterations * settings.MinBatchNs * 1.2 / elapsedNs) : iterations * 100;
+			iterations = SMath::Min(SMath::Max(estimated, iterations * 2), SMath::Min(iterations * 100, settings.MaxIterations));
+		}
+
+		result.Iterations = iterations;
+		result.NsPerOp = -1.0;
+
+		for (int32 i = 0; i < SMath::Max(settings.BatchesNum, 1); ++i)
+		{
+			SMemory::SStats stats;
+			const int64 elapsedNs = MeasureImpl(func, iterations, &stats);
+
+			const double nsPerOp = (double)elapsedNs / iterations;
+			if (result.NsPerOp < 0.0 || nsPerOp < result.NsPerOp)
+			{
+				result.NsPerOp = nsPerOp;
+			}
+
+			// Allocations do not depend on timing, so the last batch is used
+			result.AllocationsPerOp = (double)stats.AllocationsNum / iterations;
+			result.BytesPerOp = (double)stats.AllocatedBytes / iterations;
+		}
+
+		return result;
+	}
+
+	// Output
+	/////////////////////////////////
+
+	static void PrintHeader()
+	{
+		char line[256];
+		const int32 num = snprintf(line, sizeof(line), "%-48s %14s %12s %12s %12s\n", "Benchmark", "Iterations", "ns/op", "allocs/op", "B/op");
+		SMisc::WriteToStdout(line, num);
+	}
+
+	static void Print(const SBenchmarkResult& result)
+	{
+		char name[128];
+		int32 nameNum = 0;
+		for (const tchar* c = result.Name; c && *c != CHAR_TERM && nameNum < (int32)sizeof(name) - 1; ++c)
+		{
+			// Names are expected to be ASCII
+			name[nameNum++] = (char)*c;
+		}
+
+		name[nameNum] = '\0';
+
+		char line[256];
+		const int32 num = SMemory::IS_TRACKING
+			? snprintf(line, sizeof(line), "%-48s %14lld %12.2f %12.2f %12.1f\n", name, (long long)result.Iterations, result.NsPerOp, result.AllocationsPerOp, result.BytesPerOp)
+			: snprintf(line, sizeof(line), "%-48s %14lld %12.2f %12s %12s\n", name, (long long)result.Iterations, result.NsPerOp, "-", "-");
+
+		SMisc::WriteToStdout(line, num);
+	}
+
+private:
+
+	template<typename FuncT>
+	static int64 MeasureImpl(FuncT& func, int64 iterations, SMemory::SStats* outStats)
+	{
+		const SMemory::SStats statsBefore = SMemory::GetThreadStats();
+		const int64 startNs = STime::GetMonotonicNanoseconds();
+
+		func(iterations);
+		ClobberMemory();
+
+		const int64 endNs = STime::GetMonotonicNanoseconds();
+		const SMemory::SStats statsAfter = SMemory::GetThreadStats();
+
+		if (outStats)
+		{
+			outStats->AllocationsNum = statsAfter.AllocationsNum - statsBefore.AllocationsNum;
+			outStats->ReallocationsNum = statsAfter.ReallocationsNum - statsBefore.ReallocationsNum;
+			outStats->FreesNum = statsAfter.FreesNum - statsBefore.FreesNum;
+			outStats->AllocatedBytes = statsAfter.AllocatedBytes - statsBefore.AllocatedBytes;
+		}
+
+		return endNs - startNs;
+	}
+};
@@ -0,0 +1,327 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/File.h"
+#include "ASTD/Math.h"
+#include "ASTD/Memory.h"
+
+// File archive working directly with platform file handle
+// * Small reads/writes are served by internal buffer (read-ahead/write-behind)
+// * Buffer overflow is written together with pending bytes by single vectored call
+// * Size of the file is cached, call Flush() to resync it after external changes
+struct SBufferedFileArchive : public SArchive
+{
+	typedef SFile::HandleType HandleType;
+
+	static constexpr SizeType DEFAULT_BUFFER_SIZE = 1 << 20; // 1 MiB
+
+	// Buffer is page aligned, so block copies and kernel transfers work with whole pages
+	static constexpr SizeType BUFFER_ALIGNMENT = 4096;
+
+	FORCEINLINE SBufferedFileArchive(EArchiveType type, EArchiveMode mode, const tchar* filename, bool overwrite, SizeType bufferSize = DEFAULT_BUFFER_SIZE)
+		: SArchive(type, mode)
+		, _bufferSize(bufferSize > 0 ? bufferSize : DEFAULT_BUFFER_SIZE)
+	{
+		OpenImpl(filename, overwrite);
+	}
+
+	FORCEINLINE virtual ~SBufferedFileArchive() override
+	{
+		CloseImpl();
+	}
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE HandleType GetHandle() const { return _handle; }
+	FORCEINLINE SizeType GetBufferSize() const { return _bufferSize; }
+
+	// Durability
+	/////////////////////////////////
+
+	// Writes pending bytes and flushes data and metadata to the storage device (fsync)
+	FORCEINLINE bool Sync() { return FlushBufferImpl() && SFile::Sync(_handle); }
+
+	// Writes pending bytes and flushes data to the storage device (fdatasync)
+	FORCEINLINE bool DataSync() { return FlushBufferImpl() && SFile::DataSync(_handle); }
+
+	// Positional
+	// * Does not move current offset
+	/////////////////////////////////
+
+	SizeType ReadBytesAt(void* ptr, SizeType size, SizeType offset)
+	{
+		if (!ptr || size <= 0 || offset < 0) return 0;
+		else if (!AllowsRead() || !IsValid()) return 0;
+		else if (!FlushBufferImpl()) return 0;
+
+		const SizeType readBytes = SFile::ReadAllAt(_handle, ptr, size, offset);
+		return readBytes > 0 ? readBytes : 0;
+	}
+
+	SizeType WriteBytesAt(const void* ptr, SizeType size, SizeType offset)
+	{
+		if (!ptr || size <= 0 || offset < 0) return 0;
+		else if (!AllowsWrite() || !IsValid()) return 0;
+		else if (!FlushBufferImpl()) return 0;
+
+		// Read-ahead might overlap written range
+		_bufferNum = 0;
+
+		const SizeType writtenBytes = SFile::WriteAllAt(_handle, ptr, size, offset);
+		if (writtenBytes > 0)
+		{
+			_fileSize = SMath::Max(_fileSize, offset + writtenBytes);
+		}
+
+		return writtenBytes > 0 ? writtenBytes : 0;
+	}
+
+	// SArchive overrides
+	/////////////////////////////////
+
+	FORCEINLINE virtual bool IsValid() const override { return SFile::IsValidHandle(_handle); }
+	FORCEINLINE virtual SFile::HandleType GetNativeHandle() const override { return _handle; }
+
+	// Writes pending bytes and resyncs cached state (size, read-ahead) with the file
+	virtual void Flush() override
+	{
+		if (!IsValid()) return;
+
+		if (!FlushBufferImpl())
+		{
+			// Bytes that were not written stay in buffer
+			return;
+		}
+
+		_bufferNum = 0;
+
+		const SizeType fileSize = SFile::GetSize(_handle);
+		if (fileSize >= 0)
+		{
+			_fileSize = fileSize;
+		}
+	}
+
+	FORCEINLINE virtual SizeType GetTotalBytes() const override { return _fileSize; }
+	FORCEINLINE virtual SizeType GetBytesOffset() const override { return _offset; }
+
+	FORCEINLINE virtual bool SetBytesOffset(SizeType offset) override
+	{
+		if (offset < 0) return false;
+
+		// Pending bytes are written lazily, once non-contiguous operation happens
+		_offset = offset;
+		return true;
+	}
+
+	virtual SizeType ReadBytes(void* ptr, SizeType size) override
+	{
+		if (!ptr || size <= 0) return 0;
+		else if (!AllowsRead() || !IsValid()) return 0;
+		else if (!FlushBufferImpl()) return 0;
+
+		uint8* out = (uint8*)ptr;
+		SizeType remaining = size;
+
+		while (remaining > 0)
+		{
+			// Serve from read-ahead
+			if (_offset >= _bufferStart && _offset < _bufferStart + _bufferNum)
+			{
+				const SizeType bufferOffset = _offset - _bufferStart;
+				const SizeType copyNum = SMath::Min(remaining, _bufferNum - bufferOffset);
+
+				SMemory::Copy(out, _buffer + bufferOffset, copyNum);
+
+				out += copyNum;
+				remaining -= copyNum;
+				_offset += copyNum;
+				continue;
+			}
+
+			if (_offset >= _fileSize)
+			{
+				break;
+			}
+
+			// Reads requested bytes and refills read-ahead with single call
+			SFileSlice slices[2] = { { out, remaining }, { _buffer, _bufferSize } };
+			const SizeType readBytes = SFile::ReadVectoredAt(_handle, slices, 2, _offset);
+			if (readBytes <= 0)
+			{
+				break;
+			}
+
+			const SizeType userBytes = SMath::Min(readBytes, remaining);
+
+			out += userBytes;
+			remaining -= userBytes;
+			_offset += userBytes;
+
+			_bufferStart = _offset;
+			_bufferNum = readBytes - userBytes;
+		}
+
+		return size - remaining;
+	}
+
+	virtual SizeType WriteBytes(const void* ptr, SizeType size) override
+	{
+		if (!ptr || size <= 0) return 0;
+		else if (!AllowsWrite() || !IsValid()) return 0;
+
+		if (!_isDirty)
+		{
+			// Read-ahead might overlap written range
+			_bufferNum = 0;
+		}
+		else if (_offset != _bufferStart + _bufferNum)
+		{
+			// Non-contiguous write, pending bytes have to go first
+			if (!FlushBufferImpl()) return 0;
+		}
+
+		if (_bufferNum == 0)
+		{
+			_bufferStart = _offset;
+		}
+
+		if (_bufferNum + size <= _bufferSize)
+		{
+			SMemory::Copy(_buffer + _bufferNum, ptr, size);
+
+			_bufferNum += size;
+			_isDirty = true;
+		}
+		else
+		{
+			// Writes pending bytes together with provided ones with single call
+			const SizeType pendingNum = _bufferNum;
+			SFileSlice slices[2] = { { _buffer, pendingNum }, { (void*)ptr, size } };
+
+			const SizeType writtenBytes = SFile::WriteVectoredAllAt(_handle, slices, 2, _bufferStart);
+			if (writtenBytes < pendingNum)
+			{
+				// Pending bytes were already reported as written, they stay buffered for the next flush
+				KeepUnwrittenImpl(writtenBytes);
+				return 0;
+			}
+
+			_bufferNum = 0;
+			_isDirty = false;
+
+			if (writtenBytes < pendingNum + size)
+			{
+				const SizeType userBytes = writtenBytes - pendingNum;
+
+				_offset += userBytes;
+				_fileSize = SMath::Max(_fileSize, _offset);
+				return userBytes;
+			}
+		}
+
+		_offset += size;
+		_fileSize = SMath::Max(_fileSize, _offset);
+
+		return size;
+	}
+
+private:
+
+	void OpenImpl(const tchar* filename, bool overwrite)
+	{
+		uint32 flags = EFileOpenFlags::None;
+		switch (GetMode())
+		{
+			case EArchiveMode::Read:
+				flags = EFileOpenFlags::Read;
+			break;
+			case EArchiveMode::Write:
+				flags = EFileOpenFlags::Write | EFileOpenFlags::Create | EFileOpenFlags::Truncate;
+			break;
+			case EArchiveMode::ReadWrite:
+				flags = EFileOpenFlags::Read | EFileOpenFlags::Write | EFileOpenFlags::Create;
+				if (overwrite) flags |= EFileOpenFlags::Truncate;
+			break;
+		}
+
+		_handle = SFile::Open(filename, flags);
+		if (!IsValid())
+		{
+			return;
+		}
+
+		_fileSize = SMath::Max<SizeType>(SFile::GetSize(_handle), 0);
+		_buffer = SMemory::MallocAlignedTyped<uint8>(_bufferSize, BUFFER_ALIGNMENT);
+	}
+
+	void CloseImpl()
+	{
+		if (IsValid())
+		{
+			FlushBufferImpl();
+			SFile::Close(_handle);
+			_handle = SFile::INVALID_HANDLE;
+		}
+
+		if (_buffer)
+		{
+			SMemory::FreeAligned(_buffer);
+			_buffer = nullptr;
+		}
+	}
+
+	// Writes pending bytes, keeps read-ahead untouched
+	bool FlushBufferImpl()
+	{
+		if (!_isDirty)
+		{
+			return true;
+		}
+
+		const SizeType pendingNum = _bufferNum;
+		const SizeType writtenBytes = SFile::WriteAllAt(_handle, _buffer, pendingNum, _bufferStart);
+		if (writtenBytes < pendingNum)
+		{
+			KeepUnwrittenImpl(writtenBytes);
+			return false;
+		}
+
+		_bufferNum = 0;
+		_isDirty = false;
+
+		return true;
+	}
+
+	// Drops written part of pending bytes, the rest stays dirty in buffer
+	void KeepUnwrittenImpl(SizeType writtenBytes)
+	{
+		const SizeType written = SMath::Max<SizeType>(writtenBytes, 0);
+		SMemory::Move(_buffer, _buffer + written, _bufferNum - written);
+
+		_bufferStart += written;
+		_bufferNum -= written;
+	}
+
+	HandleType _handle = SFile::INVALID_HANDLE;
+
+	uint8* _buffer = nullptr;
+	SizeType _bufferSize = 0;
+
+	// File offset of the first byte in buffer
+	SizeType _bufferStart = 0;
+
+	// Number of valid bytes in buffer
+	SizeType _bufferNum = 0;
+
+	// Whether buffer holds bytes not yet written to the file
+	bool _isDirty = false;
+
+	SizeType _offset = 0;
+	SizeType _fileSize = 0;
+};
@@ -73,6 +73,86 @@
 	#define ARCHITECTURE_64 0
 #endif
 
+// Instruction set
+// * Supported: X86, ARM
+// * Example: ARCHITECTURE_X86
+/////////////////////////////////
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	#define ARCHITECTURE_X86 1
+#elif defined(__aarch64__) || defined(__arm__) || defined(_M_ARM64) || defined(_M_ARM)
+	#define ARCHITECTURE_ARM 1
+#endif
+
+#ifndef ARCHITECTURE_X86
+	#define ARCHITECTURE_X86 0
+#endif
+
+#ifndef ARCHITECTURE_ARM
+	#define ARCHITECTURE_ARM 0
+#endif
+
+// Instruction set extensions enabled for compiler (ex. -mavx2, /arch:AVX2)
+// * Code may use them unconditionally, runtime support of others is queried by SCpu. See Cpu.h
+// * Example: ISA_AVX2
+/////////////////////////////////
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define ISA_SSE2 1
+#endif
+
+#if defined(__SSE4_2__) || (COMPILER_MSVC && defined(__AVX__))
+	#define ISA_SSE42 1
+#endif
+
+#if defined(__AVX__)
+	#define ISA_AVX 1
+#endif
+
+#if defined(__AVX2__)
+	#define ISA_AVX2 1
+#endif
+
+#if defined(__BMI2__) || (COMPILER_MSVC && defined(__AVX2__))
+	#define ISA_BMI2 1
+#endif
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+	#define ISA_AVX512 1
+#endif
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+	#define ISA_NEON 1
+#endif
+
+#ifndef ISA_SSE2
+	#define ISA_SSE2 0
+#endif
+
+#ifndef ISA_SSE42
+	#define ISA_SSE42 0
+#endif
+
+#ifndef ISA_AVX
+	#define ISA_AVX 0
+#endif
+
+#ifndef ISA_AVX2
+	#define ISA_AVX2 0
+#endif
+
+#ifndef ISA_BMI2
+	#define ISA_BMI2 0
+#endif
+
+#ifndef ISA_AVX512
+	#define ISA_AVX512 0
+#endif
+
+#ifndef ISA_NEON
+	#define ISA_NEON 0
+#endif
+
 // Platform
 // * Supported: Windows, Linux
 // * Example: PLATFORM_WINDOWS
@@ -119,6 +199,17 @@
 	#define ASTD_TRACK_MEMORY BUILD_DEBUG
 #endif
 
+// Most verbose log level compiled in, more verbose log statements are removed. See Log.h
+// * 0 = Fatal, 1 = Error, 2 = Warning, 3 = Display, 4 = Log, 5 = Verbose, 6 = VeryVerbose
+#ifndef ASTD_LOG_COMPILE_LEVEL
+	#define ASTD_LOG_COMPILE_LEVEL (BUILD_DEBUG ? 6 : 4)
+#endif
+
+// Whether TRACE_SCOPE instrumentation is compiled in. See Trace.h
+#ifndef ASTD_TRACE
+	#define ASTD_TRACE 0
+#endif
+
 // Whether we want ASTD to suppress default build warnings defined by platform. See <Platform>Build.h
 #ifndef ASTD_DEFAULT_WARNING_SUPPRESS
 	#define ASTD_DEFAULT_WARNING_SUPPRESS 1
@@ -129,6 +220,11 @@
 	#define ASTD_NEW_DELETE 0
 #endif
 
+// Whether SMemory serves small allocations from size classes with per-thread caches instead of calling malloc. See SmallAllocator.h
+#ifndef ASTD_SMALL_ALLOCATOR
+	#define ASTD_SMALL_ALLOCATOR 0
+#endif
+
 // Platform
 /////////////////////////////////
 
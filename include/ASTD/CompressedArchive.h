@@ -0,0 +1,586 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/Array.h"
+#include "ASTD/Compression.h"
+#include "ASTD/Math.h"
+#include "ASTD/Memory.h"
+
+// TODO: Replace with custom implementation
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct SCompressedArchiveSettings
+{
+	// Number of uncompressed bytes per block (used only when writing, readers take it from the header)
+	int32 BlockSize = 256 << 10; // 256 KiB
+
+	// Number of blocks compressed in parallel (1 compresses on calling thread only)
+	int32 NumThreads = 1;
+};
+
+// Archive decorator that compresses data in independent blocks
+// * Layout: [header][block]...[end block][index][trailer]
+// * Block: [uint32 stored size (highest bit set when stored uncompressed)][uint32 raw size][data]
+// * Index stores offsets of every block, so reader can seek to any offset by decompressing a single block
+// * Write mode only appends, seeking is supported in read mode only
+// * Index is written by Finish (called from destructor), inner archive has to outlive this one
+// * Inner archive is never flushed, caller flushes it once compressed data is written
+struct SCompressedArchive : public SArchive
+{
+	static constexpr uint32 MAGIC = 0x315A4C41; // "ALZ1"
+	static constexpr uint32 INDEX_MAGIC = 0x495A4C41; // "ALZI"
+
+	FORCEINLINE explicit SCompressedArchive(SArchive& inner, const SCompressedArchiveSettings& settings = {})
+		: SArchive(EArchiveType::Binary, inner.GetMode())
+		, _inner(inner)
+		, _settings(settings)
+	{
+		if (!CHECK(inner.IsBinary()) || !CHECK(inner.GetMode() != EArchiveMode::ReadWrite))
+		{
+			_isValid = false;
+			return;
+		}
+
+		if (AllowsWrite()) OpenWriteImpl();
+		else OpenReadImpl();
+	}
+
+	SCompressedArchive(const SCompressedArchive&) = delete;
+	SCompressedArchive& operator=(const SCompressedArchive&) = delete;
+
+	FORCEINLINE virtual ~SCompressedArchive() override
+	{
+		Finish();
+		StopWorkersImpl();
+
+		for (SBlock* block : _blocks)
+		{
+			delete block;
+		}
+	}
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE SArchive& GetInner() const { return _inner; }
+
+	// Whether reader found the block index (seeking and GetTotalBytes are available)
+	FORCEINLINE bool HasIndex() const { return _hasIndex; }
+
+	// Gets number of compressed bytes written to/read from inner archive so far
+	FORCEINLINE SizeType GetCompressedBytes() const { return _inner.GetBytesOffset() - _startOffset; }
+
+	// Writing
+	/////////////////////////////////
+
+	// Compresses pending data and writes block index
+	// * No more data can be written afterwards
+	void Finish()
+	{
+		if (!AllowsWrite() || _finished || !IsValid())
+		{
+			return;
+		}
+
+		FlushBlocksImpl();
+
+		const uint32 endBlock[2] = { 0, 0 };
+		WriteInnerImpl(endBlock, sizeof(endBlock));
+
+		const uint64 indexOffset = _inner.GetBytesOffset() - _startOffset;
+		WriteInnerImpl(_index.GetData(), _index.GetNum() * sizeof(SIndexEntry));
+
+		const uint64 blocksNum = _index.GetNum();
+		const uint64 totalBytes = _rawOffset;
+		WriteInnerImpl(&indexOffset, sizeof(indexOffset));
+		WriteInnerImpl(&blocksNum, sizeof(blocksNum));
+		WriteInnerImpl(&totalBytes, sizeof(totalBytes));
+		WriteInnerImpl(&INDEX_MAGIC, sizeof(INDEX_MAGIC));
+
+		_finished = true;
+	}
+
+	// SArchive overrides
+	/////////////////////////////////
+
+	FORCEINLINE virtual bool IsValid() const override { return _isValid && _inner.IsValid(); }
+
+	// Compresses pending data and writes it to inner archive
+	// * Every flush ends the current block, frequent flushes make compression worse
+	virtual void Flush() override
+	{
+		if (AllowsWrite() && !_finished && IsValid())
+		{
+			FlushBlocksImpl();
+		}
+	}
+
+	// Gets total number of uncompressed bytes
+	// * Without index in read mode only bytes read so far (including current block) are known
+	virtual SizeType GetTotalBytes() const override
+	{
+		if (AllowsWrite()) return GetBytesOffset();
+		else if (_hasIndex) return _totalBytes;
+
+		return _blockRawOffset + _blockNum;
+	}
+
+	// Gets offset in uncompressed bytes
+	virtual SizeType GetBytesOffset() const override
+	{
+		if (AllowsWrite()) return _rawOffset + GetPendingBytesImpl();
+		return _blockRawOffset + _blockPos;
+	}
+
+	virtual bool SetBytesOffset(SizeType offset) override
+	{
+		if (AllowsWrite() || !IsValid()) return offset == GetBytesOffset();
+		else if (offset < 0) return false;
+
+		// Inside of current block
+		if (offset >= _blockRawOffset && offset <= _blockRawOffset + _blockNum)
+		{
+			_blockPos = offset - _blockRawOffset;
+			return true;
+		}
+
+		if (!_hasIndex || offset > _totalBytes)
+		{
+			return false;
+		}
+
+		// Last block that starts at or before the offset
+		int32 low = 0;
+		int32 high = _index.GetNum() - 1;
+		while (low < high)
+		{
+			const int32 mid = (low + high + 1) / 2;
+			if ((SizeType)_index[mid].RawOffset <= offset) low = mid;
+			else high = mid - 1;
+		}
+
+		if (_index.IsEmpty() || !LoadBlockImpl(_startOffset + _index[low].InnerOffset, _index[low].RawOffset))
+		{
+			return false;
+		}
+
+		_blockPos = SMath::Min<SizeType>(offset - _blockRawOffset, _blockNum);
+		return _blockRawOffset + _blockPos == offset;
+	}
+
+	virtual SizeType ReadBytes(void* ptr, SizeType size) override
+	{
+		if (!ptr || size <= 0) return 0;
+		else if (!AllowsRead() || !IsValid()) return 0;
+
+		uint8* out = (uint8*)ptr;
+		SizeType readBytes = 0;
+		while (readBytes < size)
+		{
+			if (_blockPos == _blockNum && !LoadBlockImpl(_nextBlockOffset, _blockRawOffset + _blockNum))
+			{
+				break;
+			}
+
+			const SizeType bytes = SMath::Min(size - readBytes, _blockNum - _blockPos);
+			SMemory::Copy(out + readBytes, _blocks[0]->Raw.GetData() + _blockPos, bytes);
+
+			_blockPos += bytes;
+			readBytes += bytes;
+		}
+
+		return readBytes;
+	}
+
+	virtual SizeType WriteBytes(const void* ptr, SizeType size) override
+	{
+		if (!ptr || size <= 0) return 0;
+		else if (!AllowsWrite() || _finished || !IsValid()) return 0;
+
+		const uint8* in = (const uint8*)ptr;
+		SizeType writtenBytes = 0;
+		while (writtenBytes < size)
+		{
+			SBlock& block = *_blocks[_filledNum];
+
+			const SizeType bytes = SMath::Min<SizeType>(size - writtenBytes, _settings.BlockSize - block.RawSize);
+			SMemory::Copy(block.Raw.GetData() + block.RawSize, in + writtenBytes, bytes);
+
+			block.RawSize += (int32)bytes;
+			writtenBytes += bytes;
+
+			if (block.RawSize == _settings.BlockSize && ++_filledNum == _blocks.GetNum())
+			{
+				WriteBlocksImpl();
+				if (!IsValid()) break;
+			}
+		}
+
+		return writtenBytes;
+	}
+
+private:
+
+	struct SBlock
+	{
+		TArray<uint8> Raw = {};
+		TArray<uint8> Compressed = {};
+		int32 RawSize = 0;
+		int32 CompressedSize = 0;
+	};
+
+	struct SIndexEntry
+	{
+		uint64 InnerOffset;
+		uint64 RawOffset;
+	};
+
+	static constexpr uint32 STORED_FLAG = 1u << 31;
+	static constexpr int32 MAX_BLOCK_SIZE = 1 << 30;
+
+	// Open
+	/////////////////////////////////
+
+	void OpenWriteImpl()
+	{
+		_settings.BlockSize = SMath::Clamp(_settings.BlockSize, 1 << 10, MAX_BLOCK_SIZE);
+		_settings.NumThreads = SMath::Max(_settings.NumThreads, 1);
+
+		_startOffset = _inner.GetBytesOffset();
+		_isValid = true;
+
+		const uint32 header[2] = { MAGIC, (uint32)_settings.BlockSize };
+		WriteInnerImpl(header, sizeof(header));
+
+		for (int32 i = 0; i < _settings.NumThreads; ++i)
+		{
+			SBlock* block = new SBlock();
+			block->Raw.AddUninitialized(_settings.BlockSize);
+			block->Compressed.AddUninitialized(SCompression::GetMaxCompressedSize(_settings.BlockSize));
+
+			_blocks.Add(block);
+		}
+
+		for (int32 i = 1; i < _settings.NumThreads; ++i)
+		{
+			_workers.Add(new std::thread([this]() { WorkerLoopImpl(); }));
+		}
+	}
+
+	void OpenReadImpl()
+	{
+		_startOffset = _inner.GetBytesOffset();
+
+		uint32 header[2];
+		if (_inner.ReadBytes(header, sizeof(header)) != sizeof(header) || header[0] != MAGIC)
+		{
+			return;
+		}
+		else if (header[1] == 0 || header[1] > (uint32)MAX_BLOCK_SIZE)
+		{
+			return;
+		}
+
+		_settings.BlockSize = (int32)header[1];
+		_nextBlockOffset = _inner.GetBytesOffset();
+		_isValid = true;
+
+		SBlock* block = new SBlock();
+		block->Raw.AddUninitialized(_settings.BlockSize);
+		_blocks.Add(block);
+
+		ReadIndexImpl();
+		_inner.SetBytesOffset(_nextBlockOffset);
+	}
+
+	void ReadIndexImpl()
+	{
+		constexpr SizeType TRAILER_SIZE = 3 * sizeof(uint64) + sizeof(uint32);
+
+		const SizeType endOffset = _inner.GetTotalBytes();
+		if (endOffset - _nextBlockOffset < TRAILER_SIZE || !_inner.SetBytesOffset(endOffset - TRAILER_SIZE))
+		{
+			return;
+		}
+
+		uint64 indexOffset, blocksNum, totalBytes;
+		uint32 magic = 0;
+		_inner.ReadBytes(&indexOffset, sizeof(indexOffset));
+		_inner.ReadBytes(&blocksNum, sizeof(blocksNum));
+		_inner.ReadBytes(&totalBytes, sizeof(totalBytes));
+		_inner.ReadBytes(&magic, sizeof(magic));
+
+		const SizeType indexBytes = (SizeType)(blocksNum * sizeof(SIndexEntry));
+		if (magic != INDEX_MAGIC || _startOffset + indexOffset + indexBytes + TRAILER_SIZE != (uint64)endOffset)
+		{
+			return;
+		}
+
+		_index.AddUninitialized(blocksNum);
+		if (!_inner.SetBytesOffset(_startOffset + indexOffset) || _inner.ReadBytes(_index.GetData(), indexBytes) != indexBytes)
+		{
+			_index.Empty();
+			return;
+		}
+
+		_totalBytes = totalBytes;
+		_hasIndex = true;
+	}
+
+	// Reading
+	/////////////////////////////////
+
+	bool LoadBlockImpl(SizeType innerOffset, SizeType rawOffset)
+	{
+		if (!_inner.SetBytesOffset(innerOffset))
+		{
+			return false;
+		}
+
+		uint32 header[2];
+		if (_inner.ReadBytes(header, sizeof(header)) != sizeof(header))
+		{
+			return false;
+		}
+
+		const bool stored = header[0] & STORED_FLAG;
+		const int32 storedSize = (int32)(header[0] & ~STORED_FLAG);
+		const int32 rawSize = (int32)header[1];
+
+		if (storedSize == 0)
+		{
+			// End block
+			return false;
+		}
+		else if (rawSize <= 0 || rawSize > _settings.BlockSize || storedSize > SCompression::GetMaxCompressedSize(_settings.BlockSize))
+		{
+			_isValid = false;
+			return false;
+		}
+
+		SBlock& block = *_blocks[0];
+		if (stored)
+		{
+			if (storedSize != rawSize || _inner.ReadBytes(block.Raw.GetData(), rawSize) != rawSize)
+			{
+				_isValid = false;
+				return false;
+			}
+		}
+		else
+		{
+			if (block.Compressed.GetNum() < storedSize)
+			{
+				block.Compressed.AddUninitialized(storedSize - block.Compressed.GetNum());
+			}
+
+			if (_inner.ReadBytes(block.Compressed.GetData(), storedSize) != storedSize
+				|| SCompression::Decompress(block.Compressed.GetData(), storedSize, block.Raw.GetData(), rawSize) != rawSize)
+			{
+				_isValid = false;
+				return false;
+			}
+		}
+
+		_nextBlockOffset = _inner.GetBytesOffset();
+		_blockRawOffset = rawOffset;
+		_blockNum = rawSize;
+		_blockPos = 0;
+
+		return true;
+	}
+
+	// Writing
+	/////////////////////////////////
+
+	FORCEINLINE SizeType GetPendingBytesImpl() const
+	{
+		SizeType bytes = 0;
+		for (int32 i = 0; i <= _filledNum && i < _blocks.GetNum(); ++i)
+		{
+			bytes += _blocks[i]->RawSize;
+		}
+
+		return bytes;
+	}
+
+	FORCEINLINE void WriteInnerImpl(const void* ptr, SizeType size)
+	{
+		if (_inner.WriteBytes(ptr, size) != size)
+		{
+			_isValid = false;
+		}
+	}
+
+	// Writes full blocks together with the partially filled one
+	FORCEINLINE void FlushBlocksImpl()
+	{
+		if (_filledNum < _blocks.GetNum() && _blocks[_filledNum]->RawSize > 0)
+		{
+			++_filledNum;
+		}
+
+		if (_filledNum > 0)
+		{
+			WriteBlocksImpl();
+		}
+	}
+
+	// Compresses filled blocks (in parallel when workers exist) and writes them in order
+	void WriteBlocksImpl()
+	{
+		_batchNum = _filledNum;
+		_nextBlock = 0;
+
+		if (!_workers.IsEmpty() && _batchNum > 1)
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_busyWorkersNum = _workers.GetNum();
+				++_generation;
+			}
+
+			_workCondition.notify_all();
+			CompressBlocksImpl();
+
+			std::unique_lock<std::mutex> lock(_mutex);
+			_doneCondition.wait(lock, [this]() { return _busyWorkersNum == 0; });
+		}
+		else
+		{
+			CompressBlocksImpl();
+		}
+
+		for (int32 i = 0; i < _batchNum; ++i)
+		{
+			SBlock& block = *_blocks[i];
+
+			SIndexEntry& entry = _index.AddUninitialized_GetRef();
+			entry.InnerOffset = _inner.GetBytesOffset() - _startOffset;
+			entry.RawOffset = _rawOffset;
+
+			const bool stored = block.CompressedSize == 0;
+			const uint32 header[2] = {
+				stored ? (block.RawSize | STORED_FLAG) : (uint32)block.CompressedSize,
+				(uint32)block.RawSize
+			};
+
+			WriteInnerImpl(header, sizeof(header));
+			if (stored) WriteInnerImpl(block.Raw.GetData(), block.RawSize);
+			else WriteInnerImpl(block.Compressed.GetData(), block.CompressedSize);
+
+			_rawOffset += block.RawSize;
+			block.RawSize = 0;
+		}
+
+		_filledNum = 0;
+	}
+
+	void CompressBlocksImpl()
+	{
+		int32 idx;
+		while ((idx = _nextBlock.fetch_add(1)) < _batchNum)
+		{
+			SBlock& block = *_blocks[idx];
+
+			const int64 compressedSize = SCompression::Compress(block.Raw.GetData(), block.RawSize, block.Compressed.GetData(), block.Compressed.GetNum());
+
+			// Incompressible data is stored as it is
+			block.CompressedSize = (compressedSize > 0 && compressedSize < block.RawSize) ? (int32)compressedSize : 0;
+		}
+	}
+
+	void WorkerLoopImpl()
+	{
+		uint64 generation = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_workCondition.wait(lock, [this, generation]() { return _stopping || _generation != generation; });
+
+				if (_stopping)
+				{
+					return;
+				}
+
+				generation = _generation;
+			}
+
+			CompressBlocksImpl();
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				--_busyWorkersNum;
+			}
+
+			_doneCondition.notify_all();
+		}
+	}
+
+	void StopWorkersImpl()
+	{
+		if (_workers.IsEmpty())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopping = true;
+		}
+
+		_workCondition.notify_all();
+		for (std::thread* worker : _workers)
+		{
+			worker->join();
+			delete worker;
+		}
+
+		_workers.Empty();
+	}
+
+	SArchive& _inner;
+	SCompressedArchiveSettings _settings = {};
+
+	// Offset of the header in inner archive
+	SizeType _startOffset = 0;
+
+	bool _isValid = false;
+	bool _finished = false;
+
+	// Blocks (single block used for decompression in read mode)
+	TArray<SBlock*> _blocks = {};
+	TArray<SIndexEntry> _index = {};
+
+	// Write state
+	SizeType _rawOffset = 0;
+	int32 _filledNum = 0;
+
+	// Read state
+	SizeType _nextBlockOffset = 0;
+	SizeType _blockRawOffset = 0;
+	SizeType _blockNum = 0;
+	SizeType _blockPos = 0;
+	SizeType _totalBytes = 0;
+	bool _hasIndex = false;
+
+	// Parallel compression
+	TArray<std::thread*> _workers = {};
+	std::atomic<int32> _nextBlock = { 0 };
+	int32 _batchNum = 0;
+	int32 _busyWorkersNum = 0;
+	uint64 _generation = 0;
+
+	std::mutex _mutex = {};
+	std::condition_variable _workCondition = {};
+	std::condition_variable _doneCondition = {};
+	bool _stopping = false;
+};
@@ -0,0 +1,248 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Memory.h"
+
+// Fast LZ block codec
+// * Uses LZ4 block layout: sequences of [token][literals length][literals][offset][match length]
+// * Favours speed over ratio, single hash probe per position with skipping over incompressible data
+// * Blocks are independent, there is no dictionary shared between them
+struct SCompression
+{
+	// Gets size of the buffer that is always big enough to hold compressed data
+	FORCEINLINE static int64 GetMaxCompressedSize(int64 size) { return size + size / 255 + 16; }
+
+	// Compresses data into "dst"
+	// * Returns compressed size or 0 when it does not fit into "dstCapacity"
+	static int64 Compress(const void* src, int64 srcSize, void* dst, int64 dstCapacity)
+	{
+		const uint8* const in = (const uint8*)src;
+		uint8* const out = (uint8*)dst;
+
+		int64 op = 0;
+		int64 anchor = 0;
+
+		if (srcSize > MIN_INPUT_SIZE)
+		{
+			// Position + 1, so zero means empty slot
+			uint32 table[HASH_SIZE];
+			SMemory::ZeroTyped(table, HASH_SIZE);
+
+			const int64 matchLimit = srcSize - MATCH_SAFE_DISTANCE;
+			const int64 extendLimit = srcSize - LAST_LITERALS;
+
+			int64 ip = 1;
+			while (ip < matchLimit)
+			{
+				const uint32 sequence = Read32Impl(in + ip);
+				const uint32 hash = HashImpl(sequence);
+
+				const int64 ref = (int64)table[hash] - 1;
+				table[hash] = (uint32)(ip + 1);
+
+				if (ref < 0 || ip - ref > MAX_OFFSET || Read32Impl(in + ref) != sequence)
+				{
+					// Skips faster the longer no match was found
+					ip += 1 + ((ip - anchor) >> SKIP_SHIFT);
+					continue;
+				}
+
+				int64 matchStart = ip;
+				int64 matchRef = ref;
+				while (matchStart > anchor && matchRef > 0 && in[matchStart - 1] == in[matchRef - 1])
+				{
+					--matchStart;
+					--matchRef;
+				}
+
+				int64 matchEnd = ip + MIN_MATCH;
+				while (matchEnd < extendLimit && in[matchEnd] == in[matchRef + (matchEnd - matchStart)])
+				{
+					++matchEnd;
+				}
+
+				op = WriteSequenceImpl(in + anchor, matchStart - anchor, matchStart - matchRef, matchEnd - matchStart, out, op, dstCapacity);
+				if (op == 0)
+				{
+					return 0;
+				}
+
+				ip = anchor = matchEnd;
+				if (ip < matchLimit)
+				{
+					// Keeps table warm with position right before the next one
+					table[HashImpl(Read32Impl(in + ip - 2))] = (uint32)(ip - 2 + 1);
+				}
+			}
+		}
+
+		// Last literals
+		op = WriteSequenceImpl(in + anchor, srcSize - anchor, 0, 0, out, op, dstCapacity);
+		return op;
+	}
+
+	// Decompresses data into "dst"
+	// * Returns decompressed size or INDEX_NONE when data is malformed or does not fit into "dstCapacity"
+	static int64 Decompress(const void* src, int64 srcSize, void* dst, int64 dstCapacity)
+	{
+		const uint8* const in = (const uint8*)src;
+		uint8* const out = (uint8*)dst;
+
+		int64 ip = 0;
+		int64 op = 0;
+		while (ip < srcSize)
+		{
+			const uint8 token = in[ip++];
+
+			int64 literalsNum = token >> 4;
+			if (literalsNum == 15 && !ReadLengthImpl(in, srcSize, ip, literalsNum))
+			{
+				return INDEX_NONE;
+			}
+
+			if (literalsNum > srcSize - ip || literalsNum > dstCapacity - op)
+			{
+				return INDEX_NONE;
+			}
+
+			SMemory::Copy(out + op, in + ip, literalsNum);
+			ip += literalsNum;
+			op += literalsNum;
+
+			if (ip == srcSize)
+			{
+				// Last sequence has literals only
+				break;
+			}
+
+			if (ip + 2 > srcSize)
+			{
+				return INDEX_NONE;
+			}
+
+			const int64 offset = in[ip] | ((int64)in[ip + 1] << 8);
+			ip += 2;
+
+			int64 matchNum = token & 15;
+			if (matchNum == 15 && !ReadLengthImpl(in, srcSize, ip, matchNum))
+			{
+				return INDEX_NONE;
+			}
+
+			matchNum += MIN_MATCH;
+			if (offset == 0 || offset > op || matchNum > dstCapacity - op)
+			{
+				return INDEX_NONE;
+			}
+
+			uint8* matchDst = out + op;
+			const uint8* matchSrc = matchDst - offset;
+			if (offset >= matchNum)
+			{
+				SMemory::Copy(matchDst, matchSrc, matchNum);
+			}
+			else
+			{
+				// Overlapping match repeats last "offset" bytes
+				for (int64 i = 0; i < matchNum; ++i)
+				{
+					matchDst[i] = matchSrc[i];
+				}
+			}
+
+			op += matchNum;
+		}
+
+		return op;
+	}
+
+private:
+
+	static constexpr int32 HASH_BITS = 12;
+	static constexpr int32 HASH_SIZE = 1 << HASH_BITS;
+	static constexpr int32 SKIP_SHIFT = 6;
+
+	static constexpr int64 MIN_MATCH = 4;
+	static constexpr int64 MAX_OFFSET = 65535;
+
+	// Last bytes are always stored as literals, so decoder can copy in bigger steps
+	static constexpr int64 LAST_LITERALS = 5;
+	static constexpr int64 MATCH_SAFE_DISTANCE = 12;
+	static constexpr int64 MIN_INPUT_SIZE = MATCH_SAFE_DISTANCE + 1;
+
+	FORCEINLINE static uint32 Read32Impl(const uint8* ptr)
+	{
+		uint32 value;
+		SMemory::Copy(&value, ptr, sizeof(uint32));
+		return value;
+	}
+
+	FORCEINLINE static uint32 HashImpl(uint32 sequence) { return (sequence * 2654435761u) >> (32 - HASH_BITS); }
+
+	FORCEINLINE static bool ReadLengthImpl(const uint8* in, int64 size, int64& ip, int64& length)
+	{
+		uint8 byte;
+		do
+		{
+			if (ip >= size) return false;
+
+			byte = in[ip++];
+			length += byte;
+		}
+		while (byte == 255);
+
+		return true;
+	}
+
+	FORCEINLINE static int64 WriteLengthImpl(uint8* out, int64 op, int64 length)
+	{
+		for (; length >= 255; length -= 255)
+		{
+			out[op++] = 255;
+		}
+
+		out[op++] = (uint8)length;
+		return op;
+	}
+
+	// Writes sequence, match with zero length writes literals only
+	// * Returns new output offset or 0 when it does not fit
+	static int64 WriteSequenceImpl(const uint8* literals, int64 literalsNum, int64 offset, int64 matchNum, uint8* out, int64 op, int64 capacity)
+	{
+		const int64 required = 1 + (literalsNum / 255 + 1) + literalsNum + (matchNum > 0 ? 2 + ((matchNum - MIN_MATCH) / 255 + 1) : 0);
+		if (op + required > capacity)
+		{
+			return 0;
+		}
+
+		uint8& token = out[op++];
+		token = (uint8)((literalsNum >= 15 ? 15 : literalsNum) << 4);
+
+		if (literalsNum >= 15)
+		{
+			op = WriteLengthImpl(out, op, literalsNum - 15);
+		}
+
+		SMemory::Copy(out + op, literals, literalsNum);
+		op += literalsNum;
+
+		if (matchNum > 0)
+		{
+			out[op++] = (uint8)(offset & 0xFF);
+			out[op++] = (uint8)(offset >> 8);
+
+			const int64 matchLength = matchNum - MIN_MATCH;
+			token |= (uint8)(matchLength >= 15 ? 15 : matchLength);
+
+			if (matchLength >= 15)
+			{
+				op = WriteLengthImpl(out, op, matchLength - 15);
+			}
+		}
+
+		return op;
+	}
+};
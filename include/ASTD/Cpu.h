@@ -0,0 +1,307 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Check.h"
+
+// TODO: Replace with custom implementation
+#include <atomic>
+#include <cstdlib>
+#include <initializer_list>
+
+#if ARCHITECTURE_X86
+	#if COMPILER_MSVC
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#elif ARCHITECTURE_ARM && PLATFORM_LINUX
+	#include <sys/auxv.h>
+#endif
+
+// Compiles single function for instruction set extension, so it can be dispatched at runtime
+// * MSVC allows intrinsics everywhere, so it does nothing there
+// * Example: CPU_TARGET("avx2") uint32 HashAvx2(const uint8* data, int64 size) { ... }
+#if COMPILER_MSVC
+	#define CPU_TARGET(isa)
+#else
+	#define CPU_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+// Instruction set extensions and other CPU capabilities
+enum class ECpuFeature : uint64
+{
+	None = 0,
+
+	// x86
+	SSE2 = 1ull << 0,
+	SSE42 = 1ull << 1,
+	POPCNT = 1ull << 2,
+	AVX = 1ull << 3,
+	AVX2 = 1ull << 4,
+	FMA = 1ull << 5,
+	BMI1 = 1ull << 6,
+	BMI2 = 1ull << 7,
+	AVX512F = 1ull << 8,
+	AVX512BW = 1ull << 9,
+	AVX512VL = 1ull << 10,
+	// Time stamp counter runs at constant rate in all power states
+	InvariantTSC = 1ull << 11,
+
+	// ARM
+	NEON = 1ull << 32,
+	CRC32 = 1ull << 33,
+	SVE = 1ull << 34
+};
+
+FORCEINLINE constexpr ECpuFeature operator|(ECpuFeature lhs, ECpuFeature rhs) { return (ECpuFeature)((uint64)lhs | (uint64)rhs); }
+FORCEINLINE constexpr ECpuFeature operator&(ECpuFeature lhs, ECpuFeature rhs) { return (ECpuFeature)((uint64)lhs & (uint64)rhs); }
+FORCEINLINE constexpr ECpuFeature operator~(ECpuFeature value) { return (ECpuFeature)~(uint64)value; }
+
+// CPU feature query
+// * Features are detected once (cpuid on x86, hwcap on ARM), including OS support of extended registers
+struct SCpu
+{
+	// Features code was compiled with (ISA_* macros), these are always available
+	static constexpr ECpuFeature COMPILED_FEATURES =
+		(ISA_SSE2 ? ECpuFeature::SSE2 : ECpuFeature::None) |
+		(ISA_SSE42 ? ECpuFeature::SSE42 | ECpuFeature::POPCNT : ECpuFeature::None) |
+		(ISA_AVX ? ECpuFeature::AVX : ECpuFeature::None) |
+		(ISA_AVX2 ? ECpuFeature::AVX2 : ECpuFeature::None) |
+		(ISA_BMI2 ? ECpuFeature::BMI2 : ECpuFeature::None) |
+		(ISA_AVX512 ? ECpuFeature::AVX512F | ECpuFeature::AVX512BW | ECpuFeature::AVX512VL : ECpuFeature::None) |
+		(ISA_NEON ? ECpuFeature::NEON : ECpuFeature::None);
+
+	// Gets features supported by CPU and OS
+	FORCEINLINE static ECpuFeature GetFeatures()
+	{
+		static const ECpuFeature features = DetectFeaturesImpl();
+		return features & ~GetDisabledImpl().load(std::memory_order_relaxed);
+	}
+
+	// Checks whether all of the features are available
+	FORCEINLINE static bool HasFeatures(ECpuFeature features)
+	{
+		// Compiled features are resolved at compile time
+		return (COMPILED_FEATURES & features) == features || (GetFeatures() & features) == features;
+	}
+
+	// Hides features from GetFeatures, ex. to test fallback kernels
+	// * Has to be called before dispatchers are first used, features enabled at compile time can not be hidden
+	FORCEINLINE static void SetDisabledFeatures(ECpuFeature features) { GetDisabledImpl().store(features, std::memory_order_relaxed); }
+
+	static const char* GetFeatureName(ECpuFeature feature)
+	{
+		switch (feature)
+		{
+			case ECpuFeature::SSE2: return "SSE2";
+			case ECpuFeature::SSE42: return "SSE4.2";
+			case ECpuFeature::POPCNT: return "POPCNT";
+			case ECpuFeature::AVX: return "AVX";
+			case ECpuFeature::AVX2: return "AVX2";
+			case ECpuFeature::FMA: return "FMA";
+			case ECpuFeature::BMI1: return "BMI1";
+			case ECpuFeature::BMI2: return "BMI2";
+			case ECpuFeature::AVX512F: return "AVX512F";
+			case ECpuFeature::AVX512BW: return "AVX512BW";
+			case ECpuFeature::AVX512VL: return "AVX512VL";
+			case ECpuFeature::InvariantTSC: return "InvariantTSC";
+			case ECpuFeature::NEON: return "NEON";
+			case ECpuFeature::CRC32: return "CRC32";
+			case ECpuFeature::SVE: return "SVE";
+			default: return "Unknown";
+		}
+	}
+
+private:
+
+	static std::atomic<ECpuFeature>& GetDisabledImpl()
+	{
+		static std::atomic<ECpuFeature> disabled = { ECpuFeature::None };
+		return disabled;
+	}
+
+#if ARCHITECTURE_X86
+	FORCEINLINE static void CpuidImpl(uint32 leaf, uint32 subleaf, uint32 (&outRegs)[4])
+	{
+	#if COMPILER_MSVC
+		__cpuidex((int*)outRegs, (int)leaf, (int)subleaf);
+	#else
+		__cpuid_count(leaf, subleaf, outRegs[0], outRegs[1], outRegs[2], outRegs[3]);
+	#endif
+	}
+
+	// Gets register state enabled by OS (XCR0)
+	FORCEINLINE static uint64 GetEnabledStateImpl()
+	{
+	#if COMPILER_MSVC
+		return _xgetbv(0);
+	#else
+		uint32 eax, edx;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((uint64)edx << 32) | eax;
+	#endif
+	}
+#endif
+
+	static ECpuFeature DetectFeaturesImpl()
+	{
+		ECpuFeature result = ECpuFeature::None;
+
+#if ARCHITECTURE_X86
+		// Registers: eax, ebx, ecx, edx
+		uint32 regs[4];
+		CpuidImpl(0, 0, regs);
+		const uint32 maxLeaf = regs[0];
+
+		CpuidImpl(1, 0, regs);
+		const uint32 leaf1Ecx = regs[2];
+		const uint32 leaf1Edx = regs[3];
+
+		uint32 leaf7Ebx = 0;
+		if (maxLeaf >= 7)
+		{
+			CpuidImpl(7, 0, regs);
+			leaf7Ebx = regs[1];
+		}
+
+		auto addIf = [&result](bool condition, ECpuFeature feature) { if (condition) result = result | feature; };
+
+		addIf(leaf1Edx & (1u << 26), ECpuFeature::SSE2);
+		addIf(leaf1Ecx & (1u << 20), ECpuFeature::SSE42);
+		addIf(leaf1Ecx & (1u << 23), ECpuFeature::POPCNT);
+		addIf(leaf7Ebx & (1u << 3), ECpuFeature::BMI1);
+		addIf(leaf7Ebx & (1u << 8), ECpuFeature::BMI2);
+
+		// AVX registers are usable only when OS saves them on context switch
+		const bool hasXSave = leaf1Ecx & (1u << 27);
+		const uint64 state = hasXSave ? GetEnabledStateImpl() : 0;
+		const bool hasAvxState = (state & 0x6) == 0x6;
+		const bool hasAvx512State = (state & 0xE6) == 0xE6;
+
+		addIf(hasAvxState && (leaf1Ecx & (1u << 28)), ECpuFeature::AVX);
+		addIf(hasAvxState && (leaf1Ecx & (1u << 12)), ECpuFeature::FMA);
+		addIf(hasAvxState && (leaf7Ebx & (1u << 5)), ECpuFeature::AVX2);
+		addIf(hasAvx512State && (leaf7Ebx & (1u << 16)), ECpuFeature::AVX512F);
+		addIf(hasAvx512State && (leaf7Ebx & (1u << 30)), ECpuFeature::AVX512BW);
+		addIf(hasAvx512State && (leaf7Ebx & (1u << 31)), ECpuFeature::AVX512VL);
+
+		CpuidImpl(0x80000000, 0, regs);
+		if (regs[0] >= 0x80000007)
+		{
+			CpuidImpl(0x80000007, 0, regs);
+			addIf(regs[3] & (1u << 8), ECpuFeature::InvariantTSC);
+		}
+#elif ARCHITECTURE_ARM
+	#if ARCHITECTURE_64
+		// Advanced SIMD is mandatory on arm64
+		result = result | ECpuFeature::NEON;
+	#endif
+
+	#if PLATFORM_LINUX && ARCHITECTURE_64
+		const uint64 hwcap = getauxval(AT_HWCAP);
+		if (hwcap & (1ull << 7)) result = result | ECpuFeature::CRC32;
+		if (hwcap & (1ull << 22)) result = result | ECpuFeature::SVE;
+	#elif PLATFORM_APPLE
+		// Every Apple arm64 CPU has CRC32
+		result = result | ECpuFeature::CRC32;
+	#elif PLATFORM_WINDOWS
+		if (IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE)) result = result | ECpuFeature::CRC32;
+	#endif
+#endif
+
+		return result | COMPILED_FEATURES;
+	}
+};
+
+// Function selected by CPU features on first call, then called through cached pointer (ifunc-like)
+// * Kernels are tried in order, the first one with all features available is used
+// * Last kernel should require no features, so there is always a fallback
+// * Example:
+//	static TCpuDispatch<uint32(const uint8*, int64)> HashDispatch = {
+//		{ ECpuFeature::AVX2, &HashAvx2 },
+//		{ ECpuFeature::SSE42, &HashSse42 },
+//		{ ECpuFeature::None, &HashScalar }
+//	};
+//	const uint32 hash = HashDispatch(data, size);
+template<typename FuncT>
+struct TCpuDispatch;
+
+template<typename ReturnT, typename... ArgTypes>
+struct TCpuDispatch<ReturnT(ArgTypes...)>
+{
+	typedef ReturnT(*FuncType)(ArgTypes...);
+
+	static constexpr int32 MAX_KERNELS_NUM = 8;
+
+	struct SKernel
+	{
+		ECpuFeature Features;
+		FuncType Func;
+	};
+
+	TCpuDispatch(std::initializer_list<SKernel> kernels)
+	{
+		// Dispatcher without kernels fails on the first call
+		CHECK_RET(kernels.size() > 0 && kernels.size() <= MAX_KERNELS_NUM);
+
+		for (const SKernel& kernel : kernels)
+		{
+			_kernels[_kernelsNum++] = kernel;
+		}
+	}
+
+	TCpuDispatch(const TCpuDispatch&) = delete;
+	TCpuDispatch& operator=(const TCpuDispatch&) = delete;
+
+	FORCEINLINE ReturnT operator()(ArgTypes... args) const { return Get()(Forward<ArgTypes>(args)...); }
+
+	// Gets selected kernel, selects it on the first call
+	FORCEINLINE FuncType Get() const
+	{
+		// Every thread selects the same kernel, so racing selection is harmless
+		FuncType func = _selected.load(std::memory_order_relaxed);
+		return func ? func : SelectImpl();
+	}
+
+	// Gets features required by selected kernel
+	ECpuFeature GetSelectedFeatures() const
+	{
+		const FuncType func = Get();
+		for (int32 i = 0; i < _kernelsNum; ++i)
+		{
+			if (_kernels[i].Func == func)
+			{
+				return _kernels[i].Features;
+			}
+		}
+
+		return ECpuFeature::None;
+	}
+
+private:
+
+	FuncType SelectImpl() const
+	{
+		int32 idx = 0;
+		while (idx < _kernelsNum && !SCpu::HasFeatures(_kernels[idx].Features))
+		{
+			++idx;
+		}
+
+		// Missing fallback kernel, there is nothing that could be called
+		if (!CHECKF(idx < _kernelsNum))
+		{
+			abort();
+		}
+
+		_selected.store(_kernels[idx].Func, std::memory_order_relaxed);
+		return _kernels[idx].Func;
+	}
+
+	SKernel _kernels[MAX_KERNELS_NUM] = {};
+	int32 _kernelsNum = 0;
+	mutable std::atomic<FuncType> _selected = { nullptr };
+};
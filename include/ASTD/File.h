@@ -0,0 +1,89 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Math.h"
+#include "ASTD/_internal/FileTypes.h"
+#include PLATFORM_HEADER(File)
+
+typedef PLATFORM_PREFIXED_TYPE(S, PlatformFile) SPlatformFile;
+struct SFile : public SPlatformFile
+{
+	typedef SPlatformFile::HandleType HandleType;
+
+	FORCEINLINE static bool IsValidHandle(HandleType handle) { return handle != SPlatformFile::INVALID_HANDLE; }
+
+	// Reads until all bytes are read or end of the file is reached
+	// * returns number of read bytes
+	static int64 ReadAllAt(HandleType handle, void* buffer, int64 size, int64 offset)
+	{
+		int64 total = 0;
+		while (total < size)
+		{
+			const int64 result = SPlatformFile::ReadAt(handle, (uint8*)buffer + total, size - total, offset + total);
+			if (result <= 0) break;
+
+			total += result;
+		}
+
+		return total;
+	}
+
+	// Writes until all bytes are written or error occurs
+	// * returns number of written bytes
+	static int64 WriteAllAt(HandleType handle, const void* buffer, int64 size, int64 offset)
+	{
+		int64 total = 0;
+		while (total < size)
+		{
+			const int64 result = SPlatformFile::WriteAt(handle, (const uint8*)buffer + total, size - total, offset + total);
+			if (result <= 0) break;
+
+			total += result;
+		}
+
+		return total;
+	}
+
+	// Writes all slices, continues after partial writes
+	// * returns number of written bytes
+	static int64 WriteVectoredAllAt(HandleType handle, const SFileSlice* slices, int32 num, int64 offset)
+	{
+		SFileSlice pending[SPlatformFile::MAX_SLICES];
+
+		int64 total = 0;
+		int32 first = 0;
+		int64 firstWritten = 0;
+		while (first < num)
+		{
+			// Window of up to MAX_SLICES slices, starting after already written part of the first one
+			const int32 pendingNum = SMath::Min(num - first, SPlatformFile::MAX_SLICES);
+			for (int32 i = 0; i < pendingNum; ++i)
+			{
+				pending[i] = slices[first + i];
+			}
+
+			pending[0].Data = (uint8*)pending[0].Data + firstWritten;
+			pending[0].Size -= firstWritten;
+
+			int64 result = SPlatformFile::WriteVectoredAt(handle, pending, pendingNum, offset + total);
+			if (result <= 0) break;
+
+			total += result;
+
+			// Skip fully written slices and remember how much of partially written one is done
+			result += firstWritten;
+			while (first < num && result >= slices[first].Size)
+			{
+				result -= slices[first].Size;
+				++first;
+			}
+
+			firstWritten = result;
+		}
+
+		return total;
+	}
+};
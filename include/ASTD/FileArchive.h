@@ -29,6 +29,7 @@ struct SCFileArchive : public SArchive
 
 	FORCEINLINE virtual bool IsValid() const override { return !!_file; }
 	FORCEINLINE virtual void Flush() override { fflush(_file); }
+	FORCEINLINE virtual SFile::HandleType GetNativeHandle() const override { return SFile::GetStreamHandle(_file); }
 	virtual SizeType GetTotalBytes() const override
 	{
 		const SizeType currOff = ftell(_file);
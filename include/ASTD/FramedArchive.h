@@ -0,0 +1,382 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/Array.h"
+#include "ASTD/Optional.h"
+#include "ASTD/Shared.h"
+#include "ASTD/String.h"
+#include "ASTD/VarInt.h"
+
+// [Serialization version]
+// * Version of the type written by framed object scopes
+// * Bump when layout of serialized type changes, see DECLARE_SERIALIZATION_VERSION
+
+template<typename T>
+struct TSerializationVersion { static constexpr uint32 Value = 0; };
+
+#define DECLARE_SERIALIZATION_VERSION(Type, Version)												\
+	template<> struct TSerializationVersion<Type> { static constexpr uint32 Value = Version; };
+
+// Binary framing layer on top of any binary archive
+// * Containers are prefixed with varint length, so multiple of them can be stored back to back
+// * TOptional/TSharedPtr are written with presence flag
+// * Objects can be wrapped with TFramedObjectWriter/TFramedObjectReader for versioning and schema evolution
+// * Invalid data (ie. length past the end of the archive) puts archive into error state, see HasError
+struct SFramedArchive : public SArchive
+{
+	typedef uint64 LengthType;
+
+	FORCEINLINE explicit SFramedArchive(SArchive& inner)
+		: SArchive(EArchiveType::Binary, inner.GetMode())
+		, _inner(inner)
+	{
+		if (!CHECK(inner.IsBinary()))
+		{
+			_hasError = true;
+		}
+	}
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE SArchive& GetInner() const { return _inner; }
+
+	// Error
+	/////////////////////////////////
+
+	FORCEINLINE bool HasError() const { return _hasError; }
+	FORCEINLINE void SetError() { _hasError = true; }
+	FORCEINLINE void ClearError() { _hasError = false; }
+
+	// Framing
+	/////////////////////////////////
+
+	FORCEINLINE void WriteLength(LengthType length) { SVarInt::Write(*this, length); }
+
+	// Reads length of "elementSize" sized elements, validates it against remaining bytes
+	// * Returns 0 and sets error when length is not valid
+	LengthType ReadLength(SizeType elementSize = 0)
+	{
+		LengthType length = 0;
+		if (!SVarInt::Read(*this, length))
+		{
+			SetError();
+			return 0;
+		}
+
+		if (elementSize > 0 && length > (LengthType)(GetRemainingOffset() / elementSize))
+		{
+			SetError();
+			return 0;
+		}
+
+		return length;
+	}
+
+	FORCEINLINE void WritePresence(bool isSet) { const uint8 flag = isSet ? 1 : 0; Write(&flag, 1); }
+
+	FORCEINLINE bool ReadPresence()
+	{
+		uint8 flag = 0;
+		if (Read(&flag, 1) != 1 || flag > 1)
+		{
+			SetError();
+			return false;
+		}
+
+		return flag == 1;
+	}
+
+	// SArchive overrides
+	/////////////////////////////////
+
+	FORCEINLINE virtual bool IsValid() const override { return !_hasError && _inner.IsValid(); }
+	FORCEINLINE virtual void Flush() override { _inner.Flush(); }
+	FORCEINLINE virtual SFile::HandleType GetNativeHandle() const override { return _inner.GetNativeHandle(); }
+	FORCEINLINE virtual SizeType GetTotalBytes() const override { return _inner.GetTotalBytes(); }
+	FORCEINLINE virtual SizeType GetBytesOffset() const override { return _inner.GetBytesOffset(); }
+	FORCEINLINE virtual bool SetBytesOffset(SizeType offset) override { return _inner.SetBytesOffset(offset); }
+
+	FORCEINLINE virtual SizeType ReadBytes(void* ptr, SizeType size) override
+	{
+		if (_hasError) return 0;
+
+		const SizeType readBytes = _inner.ReadBytes(ptr, size);
+		if (readBytes != size) SetError();
+		return readBytes;
+	}
+
+	FORCEINLINE virtual SizeType WriteBytes(const void* ptr, SizeType size) override
+	{
+		if (_hasError) return 0;
+
+		const SizeType writtenBytes = _inner.WriteBytes(ptr, size);
+		if (writtenBytes != size) SetError();
+		return writtenBytes;
+	}
+
+private:
+
+	SArchive& _inner;
+	bool _hasError = false;
+};
+
+// Writes object frame: [uint32 version][uint64 payload size][payload]
+// * Payload size is patched once scope ends, so inner archive has to support seeking
+// * Payload size is fixed width (not varint), so it can be patched in place
+template<typename T>
+struct TFramedObjectWriter
+{
+	FORCEINLINE explicit TFramedObjectWriter(SFramedArchive& ar)
+		: _ar(ar)
+	{
+		const uint32 version = TSerializationVersion<T>::Value;
+		_ar.Write(&version, 1);
+
+		const SFramedArchive::LengthType payloadSize = 0;
+
+		_sizeOffset = _ar.GetBytesOffset();
+		_ar.Write(&payloadSize, 1);
+	}
+
+	TFramedObjectWriter(const TFramedObjectWriter&) = delete;
+	TFramedObjectWriter& operator=(const TFramedObjectWriter&) = delete;
+
+	~TFramedObjectWriter()
+	{
+		const SArchive::SizeType endOffset = _ar.GetBytesOffset();
+		const SFramedArchive::LengthType payloadSize = endOffset - _sizeOffset - sizeof(SFramedArchive::LengthType);
+
+		_ar.SetBytesOffset(_sizeOffset);
+		_ar.Write(&payloadSize, 1);
+		_ar.SetBytesOffset(endOffset);
+	}
+
+private:
+
+	SFramedArchive& _ar;
+	SArchive::SizeType _sizeOffset = 0;
+};
+
+// Reads object frame written by TFramedObjectWriter
+// * Version tells which fields were written
+// * Bytes not consumed by reader (fields added by newer version) are skipped once scope ends
+template<typename T>
+struct TFramedObjectReader
+{
+	FORCEINLINE explicit TFramedObjectReader(SFramedArchive& ar)
+		: _ar(ar)
+	{
+		SFramedArchive::LengthType payloadSize = 0;
+		_ar.Read(&_version, 1);
+		_ar.Read(&payloadSize, 1);
+
+		if (payloadSize > (SFramedArchive::LengthType)_ar.GetRemainingOffset())
+		{
+			_ar.SetError();
+			payloadSize = 0;
+		}
+
+		_endOffset = _ar.GetBytesOffset() + payloadSize;
+	}
+
+	TFramedObjectReader(const TFramedObjectReader&) = delete;
+	TFramedObjectReader& operator=(const TFramedObjectReader&) = delete;
+
+	~TFramedObjectReader()
+	{
+		if (_ar.HasError()) return;
+
+		if (_ar.GetBytesOffset() > _endOffset)
+		{
+			// Reader consumed more than was written
+			_ar.SetError();
+		}
+		else
+		{
+			_ar.SetBytesOffset(_endOffset);
+		}
+	}
+
+	// Gets version the object was written with
+	FORCEINLINE uint32 GetVersion() const { return _version; }
+
+	// Whether object was written by newer version than the current one
+	FORCEINLINE bool IsNewerVersion() const { return _version > TSerializationVersion<T>::Value; }
+
+private:
+
+	SFramedArchive& _ar;
+	SArchive::SizeType _endOffset = 0;
+	uint32 _version = 0;
+};
+
+// Archive operator<< && operator>>
+////////////////////////////////////////////
+
+template<typename T, typename TEnableIf<TIsArithmetic<T>::Value || TIsEnum<T>::Value>::Type* = nullptr>
+FORCEINLINE_DEBUGGABLE static SFramedArchive& operator<<(SFramedArchive& ar, const T& val)
+{
+	ar.Write(&val, 1);
+	return ar;
+}
+
+template<typename T, typename TEnableIf<TIsArithmetic<T>::Value || TIsEnum<T>::Value>::Type* = nullptr>
+FORCEINLINE_DEBUGGABLE static SFramedArchive& operator>>(SFramedArchive& ar, T& val)
+{
+	ar.Read(&val, 1);
+	return ar;
+}
+
+template<typename ElementT, typename AllocatorT>
+static SFramedArchive& operator<<(SFramedArchive& ar, const TArray<ElementT, AllocatorT>& arr)
+{
+	typedef TContainerTypeTraits<TArray<ElementT, AllocatorT>> ContainerTT;
+
+	ar.WriteLength(arr.GetNum());
+
+	if constexpr (ContainerTT::InlineMemory && TIsTriviallyCopyable<ElementT>::Value)
+	{
+		// Single bulk copy
+		ar.Write(arr.GetData(), arr.GetNum());
+	}
+	else
+	{
+		for (const ElementT& element : arr)
+		{
+			ar << element;
+		}
+	}
+
+	return ar;
+}
+
+template<typename ElementT, typename AllocatorT>
+static SFramedArchive& operator>>(SFramedArchive& ar, TArray<ElementT, AllocatorT>& arr)
+{
+	typedef TContainerTypeTraits<TArray<ElementT, AllocatorT>> ContainerTT;
+	constexpr bool bulkCopy = ContainerTT::InlineMemory && TIsTriviallyCopyable<ElementT>::Value;
+
+	// Every element takes at least one byte, that still protects from absurd allocations
+	const SFramedArchive::LengthType num = ar.ReadLength(bulkCopy ? sizeof(ElementT) : 1);
+
+	arr.Empty(num);
+	if (num == 0)
+	{
+		return ar;
+	}
+
+	if constexpr (bulkCopy)
+	{
+		// Single bulk copy
+		arr.AddUninitialized(num);
+		ar.Read(arr.GetData(), num);
+	}
+	else
+	{
+		arr.AddDefaulted(num);
+		for (ElementT& element : arr)
+		{
+			ar >> element;
+			if (ar.HasError()) break;
+		}
+	}
+
+	return ar;
+}
+
+FORCEINLINE_DEBUGGABLE static SFramedArchive& operator<<(SFramedArchive& ar, const SString& str)
+{
+	ar.WriteLength(str.GetLength());
+	ar.Write(str.GetChars(), str.GetLength());
+	return ar;
+}
+
+FORCEINLINE_DEBUGGABLE static SFramedArchive& operator>>(SFramedArchive& ar, SString& str)
+{
+	const SFramedArchive::LengthType length = ar.ReadLength(sizeof(SString::CharType));
+
+	SString::DataType data;
+	if (length > 0)
+	{
+		data.AddUninitialized(length);
+		ar.Read(data.GetData(), length);
+	}
+
+	str = SString(Move(data));
+	return ar;
+}
+
+FORCEINLINE_DEBUGGABLE static SFramedArchive& operator<<(SFramedArchive& ar, const tchar* str)
+{
+	const uint32 length = str ? SCString::GetLength(str) : 0;
+
+	ar.WriteLength(length);
+	ar.Write(str, length);
+	return ar;
+}
+
+template<typename T>
+static SFramedArchive& operator<<(SFramedArchive& ar, const TOptional<T>& optional)
+{
+	ar.WritePresence(optional.IsSet());
+	if (optional.IsSet())
+	{
+		ar << optional.GetRef();
+	}
+
+	return ar;
+}
+
+template<typename T>
+static SFramedArchive& operator>>(SFramedArchive& ar, TOptional<T>& optional)
+{
+	if (ar.ReadPresence())
+	{
+		T value = T();
+		ar >> value;
+		optional = Move(value);
+	}
+	else
+	{
+		optional.Reset();
+	}
+
+	return ar;
+}
+
+template<typename T, ESPMode Mode>
+static SFramedArchive& operator<<(SFramedArchive& ar, const TSharedPtr<T, Mode>& sharedPtr)
+{
+	ar.WritePresence(sharedPtr.IsValid());
+	if (sharedPtr.IsValid())
+	{
+		ar << *sharedPtr;
+	}
+
+	return ar;
+}
+
+template<typename T, ESPMode Mode>
+static SFramedArchive& operator>>(SFramedArchive& ar, TSharedPtr<T, Mode>& sharedPtr)
+{
+	if (ar.ReadPresence())
+	{
+		if (!sharedPtr.IsValid())
+		{
+			sharedPtr = MakeShared<T, Mode>();
+		}
+
+		ar >> *sharedPtr;
+	}
+	else
+	{
+		sharedPtr.Reset();
+	}
+
+	return ar;
+}
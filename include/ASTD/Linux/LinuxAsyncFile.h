@@ -0,0 +1,310 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "ASTD/Linux/LinuxBuild.h"
+#include "ASTD/Linux/LinuxFile.h"
+#include "ASTD/_internal/FileTypes.h"
+
+#if HAS_INCLUDE(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+	#include <linux/io_uring.h>
+	#define ASTD_HAS_IO_URING 1
+#else
+	#define ASTD_HAS_IO_URING 0
+#endif
+
+// Asynchronous file queue implemented on top of io_uring
+// * Talks to kernel directly through syscalls, no liburing dependency
+// * Init fails when kernel does not support io_uring (or it is disallowed), caller is expected to fallback
+struct SLinuxPlatformAsyncFileQueue
+{
+	typedef SLinuxPlatformFile::HandleType HandleType;
+
+	FORCEINLINE SLinuxPlatformAsyncFileQueue() = default;
+
+	SLinuxPlatformAsyncFileQueue(const SLinuxPlatformAsyncFileQueue&) = delete;
+	SLinuxPlatformAsyncFileQueue& operator=(const SLinuxPlatformAsyncFileQueue&) = delete;
+
+	FORCEINLINE ~SLinuxPlatformAsyncFileQueue() { Shutdown(); }
+
+	// Whether queue was successfully initialized
+	FORCEINLINE bool IsInitialized() const { return _ringHandle >= 0; }
+
+	// Gets number of operations that can be queued before submission is needed
+	FORCEINLINE uint32 GetDepth() const { return _sqEntries; }
+
+	// Gets number of queued operations not yet passed to kernel
+	FORCEINLINE uint32 GetPendingNum() const { return _pendingNum; }
+
+#if ASTD_HAS_IO_URING
+
+	bool Init(uint32 depth)
+	{
+		if (IsInitialized()) return true;
+
+		io_uring_params params = {};
+		const int32 ringHandle = (int32)syscall(__NR_io_uring_setup, depth, &params);
+		if (ringHandle < 0)
+		{
+			return false;
+		}
+
+		// IORING_OP_READ/WRITE are available since the same kernel as this feature
+		if (!(params.features & IORING_FEAT_RW_CUR_POS))
+		{
+			close(ringHandle);
+			return false;
+		}
+
+		_ringHandle = ringHandle;
+		_sqEntries = params.sq_entries;
+
+		_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32);
+		_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+		const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+		if (singleMap)
+		{
+			_sqRingSize = _cqRingSize = (_sqRingSize > _cqRingSize ? _sqRingSize : _cqRingSize);
+		}
+
+		_sqRing = (uint8*)MapImpl(_sqRingSize, IORING_OFF_SQ_RING);
+		_cqRing = singleMap ? _sqRing : (uint8*)MapImpl(_cqRingSize, IORING_OFF_CQ_RING);
+		_sqes = (io_uring_sqe*)MapImpl(params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES);
+
+		if (!_sqRing || !_cqRing || !_sqes)
+		{
+			Shutdown();
+			return false;
+		}
+
+		_sqHead = (uint32*)(_sqRing + params.sq_off.head);
+		_sqTail = (uint32*)(_sqRing + params.sq_off.tail);
+		_sqMask = *(uint32*)(_sqRing + params.sq_off.ring_mask);
+		_sqArray = (uint32*)(_sqRing + params.sq_off.array);
+
+		_cqHead = (uint32*)(_cqRing + params.cq_off.head);
+		_cqTail = (uint32*)(_cqRing + params.cq_off.tail);
+		_cqMask = *(uint32*)(_cqRing + params.cq_off.ring_mask);
+		_cqes = (io_uring_cqe*)(_cqRing + params.cq_off.cqes);
+
+		return true;
+	}
+
+	void Shutdown()
+	{
+		if (_sqes) munmap(_sqes, _sqEntries * sizeof(io_uring_sqe));
+		if (_cqRing && _cqRing != _sqRing) munmap(_cqRing, _cqRingSize);
+		if (_sqRing) munmap(_sqRing, _sqRingSize);
+
+		_sqes = nullptr;
+		_cqRing = nullptr;
+		_sqRing = nullptr;
+
+		if (_ringHandle >= 0)
+		{
+			close(_ringHandle);
+			_ringHandle = -1;
+		}
+
+		_sqEntries = 0;
+		_pendingNum = 0;
+	}
+
+	// Registers buffers with kernel, so operations using them can skip page pinning
+	bool RegisterBuffers(const SFileSlice* buffers, int32 num)
+	{
+		if (!IsInitialized() || num <= 0) return false;
+
+		iovec vectors[SLinuxPlatformFile::MAX_SLICES];
+		num = num < SLinuxPlatformFile::MAX_SLICES ? num : SLinuxPlatformFile::MAX_SLICES;
+		for (int32 i = 0; i < num; ++i)
+		{
+			vectors[i].iov_base = buffers[i].Data;
+			vectors[i].iov_len = buffers[i].Size;
+		}
+
+		return syscall(__NR_io_uring_register, _ringHandle, IORING_REGISTER_BUFFERS, vectors, num) == 0;
+	}
+
+	bool UnregisterBuffers()
+	{
+		if (!IsInitialized()) return false;
+		return syscall(__NR_io_uring_register, _ringHandle, IORING_UNREGISTER_BUFFERS, nullptr, 0) == 0;
+	}
+
+	// Queues operation, it is not passed to kernel till Submit is called
+	// * bufferIndex is index of registered buffer containing data or INDEX_NONE
+	// * returns false when submission queue is full
+	bool Queue(HandleType handle, EAsyncFileOp op, void* data, uint32 size, int64 offset, int32 bufferIndex, uint64 userData)
+	{
+		const uint32 tail = *_sqTail;
+		const uint32 head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+		if (tail - head >= _sqEntries)
+		{
+			return false;
+		}
+
+		const uint32 index = tail & _sqMask;
+		io_uring_sqe* sqe = &_sqes[index];
+		*sqe = {};
+
+		const bool fixed = bufferIndex >= 0;
+		if (op == EAsyncFileOp::Read)
+		{
+			sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+		}
+		else
+		{
+			sqe->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+		}
+
+		sqe->fd = handle;
+		sqe->addr = (uint64)data;
+		sqe->len = size;
+		sqe->off = (uint64)offset;
+		sqe->buf_index = fixed ? (uint16)bufferIndex : 0;
+		sqe->user_data = userData;
+
+		_sqArray[index] = index;
+		__atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+		++_pendingNum;
+		return true;
+	}
+
+	// Passes all queued operations to kernel with single call
+	// * returns number of submitted operations or negative error code
+	int32 Submit()
+	{
+		if (_pendingNum == 0) return 0;
+
+		int32 result;
+		do { result = EnterImpl(_pendingNum, 0, 0); } while (result < 0 && errno == EINTR);
+
+		if (result < 0)
+		{
+			return -errno;
+		}
+
+		_pendingNum -= result;
+		return result;
+	}
+
+	// Takes back queued operations kernel did not consume (ex. after failed Submit)
+	// * returns number of operations, their user data is written to outCompletions
+	int32 TakeBackPending(SAsyncFileCompletion* outCompletions, int32 maxNum)
+	{
+		const uint32 head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+		uint32 tail = *_sqTail;
+
+		int32 num = 0;
+		while (tail != head && num < maxNum)
+		{
+			--tail;
+
+			outCompletions[num].UserData = _sqes[_sqArray[tail & _sqMask]].user_data;
+			outCompletions[num].Result = 0;
+			++num;
+		}
+
+		__atomic_store_n(_sqTail, tail, __ATOMIC_RELEASE);
+		_pendingNum -= num;
+		return num;
+	}
+
+	// Gets finished operations
+	// * When wait is true, blocks till at least one operation finishes
+	// * returns number of operations or negative error code when waiting failed
+	int32 Reap(SAsyncFileCompletion* outCompletions, int32 maxNum, bool wait)
+	{
+		uint32 head = *_cqHead;
+		uint32 tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+
+		if (head == tail && wait)
+		{
+			int32 result;
+			do { result = EnterImpl(0, 1, IORING_ENTER_GETEVENTS); } while (result < 0 && errno == EINTR);
+
+			if (result < 0)
+			{
+				return -errno;
+			}
+
+			tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+		}
+
+		int32 num = 0;
+		while (head != tail && num < maxNum)
+		{
+			const io_uring_cqe& cqe = _cqes[head & _cqMask];
+			outCompletions[num].UserData = cqe.user_data;
+			outCompletions[num].Result = cqe.res;
+
+			++head;
+			++num;
+		}
+
+		__atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+		return num;
+	}
+
+private:
+
+	FORCEINLINE int32 EnterImpl(uint32 toSubmit, uint32 minComplete, uint32 flags)
+	{
+		return (int32)syscall(__NR_io_uring_enter, _ringHandle, toSubmit, minComplete, flags, nullptr, 0);
+	}
+
+	FORCEINLINE void* MapImpl(uint64 size, int64 offset)
+	{
+		void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringHandle, offset);
+		return ptr != MAP_FAILED ? ptr : nullptr;
+	}
+
+	uint8* _sqRing = nullptr;
+	uint8* _cqRing = nullptr;
+	io_uring_sqe* _sqes = nullptr;
+	io_uring_cqe* _cqes = nullptr;
+
+	uint32* _sqHead = nullptr;
+	uint32* _sqTail = nullptr;
+	uint32* _sqArray = nullptr;
+	uint32 _sqMask = 0;
+
+	uint32* _cqHead = nullptr;
+	uint32* _cqTail = nullptr;
+	uint32 _cqMask = 0;
+
+	uint64 _sqRingSize = 0;
+	uint64 _cqRingSize = 0;
+
+#else
+
+	FORCEINLINE bool Init(uint32) { return false; }
+	FORCEINLINE void Shutdown() {}
+
+	FORCEINLINE bool RegisterBuffers(const SFileSlice*, int32) { return false; }
+	FORCEINLINE bool UnregisterBuffers() { return false; }
+
+	FORCEINLINE bool Queue(HandleType, EAsyncFileOp, void*, uint32, int64, int32, uint64) { return false; }
+	FORCEINLINE int32 Submit() { return -1; }
+	FORCEINLINE int32 TakeBackPending(SAsyncFileCompletion*, int32) { return 0; }
+	FORCEINLINE int32 Reap(SAsyncFileCompletion*, int32, bool) { return 0; }
+
+private:
+
+#endif
+
+	int32 _ringHandle = -1;
+	uint32 _sqEntries = 0;
+
+	// Number of queued operations not yet passed to kernel
+	uint32 _pendingNum = 0;
+};
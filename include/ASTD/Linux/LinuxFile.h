@@ -0,0 +1,244 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "ASTD/Linux/LinuxBuild.h"
+#include "ASTD/_internal/FileTypes.h"
+
+struct SLinuxPlatformFile
+{
+	typedef int32 HandleType;
+
+	static constexpr HandleType INVALID_HANDLE = -1;
+
+	// Maximum number of slices passed to single vectored system call
+	static constexpr int32 MAX_SLICES = 16;
+
+	// Maximum number of bytes copied by single kernel copy call
+	static constexpr int64 MAX_COPY_CHUNK = 1 << 30;
+
+	// Opens file, returns INVALID_HANDLE on failure
+	static HandleType Open(const tchar* filename, uint32 flags)
+	{
+		int32 nativeFlags = O_CLOEXEC;
+
+		const bool read = flags & EFileOpenFlags::Read;
+		const bool write = flags & EFileOpenFlags::Write;
+		nativeFlags |= (read && write) ? O_RDWR : (write ? O_WRONLY : O_RDONLY);
+
+		if (flags & EFileOpenFlags::Create) nativeFlags |= O_CREAT;
+		if (flags & EFileOpenFlags::Truncate) nativeFlags |= O_TRUNC;
+		if (flags & EFileOpenFlags::Direct) nativeFlags |= O_DIRECT;
+
+		HandleType handle;
+		do { handle = open(filename, nativeFlags, 0644); } while (handle < 0 && errno == EINTR);
+
+		return handle >= 0 ? handle : INVALID_HANDLE;
+	}
+
+	// Closes file
+	FORCEINLINE static void Close(HandleType handle) { close(handle); }
+
+	// Gets handle used by C stream, stream has to be flushed before handle is used directly
+	FORCEINLINE static HandleType GetStreamHandle(FILE* stream) { return stream ? fileno(stream) : INVALID_HANDLE; }
+
+	// Gets size of the file in bytes, -1 on failure
+	static int64 GetSize(HandleType handle)
+	{
+		struct stat info;
+		return fstat(handle, &info) == 0 ? (int64)info.st_size : -1;
+	}
+
+	// Changes size of the file
+	FORCEINLINE static bool Truncate(HandleType handle, int64 size) { return ftruncate(handle, size) == 0; }
+
+	// Reads bytes from specific offset, does not move file position (pread)
+	static int64 ReadAt(HandleType handle, void* buffer, int64 size, int64 offset)
+	{
+		ssize_t result;
+		do { result = pread(handle, buffer, size, offset); } while (result < 0 && errno == EINTR);
+		return result;
+	}
+
+	// Writes bytes to specific offset, does not move file position (pwrite)
+	static int64 WriteAt(HandleType handle, const void* buffer, int64 size, int64 offset)
+	{
+		ssize_t result;
+		do { result = pwrite(handle, buffer, size, offset); } while (result < 0 && errno == EINTR);
+		return result;
+	}
+
+	// Reads bytes from specific offset into multiple blocks (preadv)
+	// * Slices are processed in batches of MAX_SLICES, stops after the first short batch
+	static int64 ReadVectoredAt(HandleType handle, const SFileSlice* slices, int32 num, int64 offset)
+	{
+		return VectoredImpl(slices, num, offset, [handle](const iovec* vectors, int32 vectorsNum, int64 batchOffset) {
+			return preadv(handle, vectors, vectorsNum, batchOffset);
+		});
+	}
+
+	// Writes bytes to specific offset from multiple blocks (pwritev)
+	// * Slices are processed in batches of MAX_SLICES, stops after the first short batch
+	static int64 WriteVectoredAt(HandleType handle, const SFileSlice* slices, int32 num, int64 offset)
+	{
+		return VectoredImpl(slices, num, offset, [handle](const iovec* vectors, int32 vectorsNum, int64 batchOffset) {
+			return pwritev(handle, vectors, vectorsNum, batchOffset);
+		});
+	}
+
+	// Flushes data and metadata of the file to the storage device
+	FORCEINLINE static bool Sync(HandleType handle) { return fsync(handle) == 0; }
+
+	// Flushes data of the file to the storage device, metadata only when needed to retrieve data
+	FORCEINLINE static bool DataSync(HandleType handle) { return fdatasync(handle) == 0; }
+
+	// Copies bytes between two handles inside the kernel (copy_file_range, sendfile or splice)
+	// * Offsets are ignored for handles that are not regular files (pipes, sockets)
+	// * Returns number of copied bytes or -1 when kernel copy is not possible for given handles
+	static int64 CopyRange(HandleType from, int64 fromOffset, HandleType to, int64 toOffset, int64 size)
+	{
+		struct stat fromInfo, toInfo;
+		if (fstat(from, &fromInfo) != 0 || fstat(to, &toInfo) != 0)
+		{
+			return -1;
+		}
+
+		const bool fromFile = S_ISREG(fromInfo.st_mode);
+		const bool toFile = S_ISREG(toInfo.st_mode);
+		const bool fromPipe = S_ISFIFO(fromInfo.st_mode);
+
+		if (!fromFile && !fromPipe)
+		{
+			return -1;
+		}
+
+		// copy_file_range is not supported across some file systems, sendfile is used instead
+		bool useRangeCopy = fromFile && toFile;
+
+		int64 total = 0;
+		while (total < size)
+		{
+			const size_t chunk = (size_t)(size - total < MAX_COPY_CHUNK ? size - total : MAX_COPY_CHUNK);
+
+			loff_t fromPosition = fromOffset + total;
+			loff_t toPosition = toOffset + total;
+
+			ssize_t result;
+			if (useRangeCopy)
+			{
+				result = copy_file_range(from, &fromPosition, to, &toPosition, chunk, 0);
+				if (result < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP))
+				{
+					// sendfile writes at the current position of the output
+					if (lseek(to, toPosition, SEEK_SET) < 0) break;
+
+					useRangeCopy = false;
+					continue;
+				}
+			}
+			else if (fromFile)
+			{
+				result = sendfile(to, from, &fromPosition, chunk);
+			}
+			else
+			{
+				result = splice(from, nullptr, to, toFile ? &toPosition : nullptr, chunk, SPLICE_F_MOVE);
+			}
+
+			if (result < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			else if (result <= 0)
+			{
+				break;
+			}
+
+			total += result;
+		}
+
+		return (total > 0 || size == 0) ? total : -1;
+	}
+
+	// Maps first "size" bytes of the file into memory
+	static bool Map(HandleType handle, int64 size, bool writable, SFileMapping& outMapping)
+	{
+		void* data = mmap(nullptr, size, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, handle, 0);
+		if (data == MAP_FAILED)
+		{
+			return false;
+		}
+
+		outMapping.Data = (uint8*)data;
+		outMapping.Size = size;
+		outMapping.Native = nullptr;
+		return true;
+	}
+
+	// Unmaps previously mapped region
+	static void Unmap(SFileMapping& mapping)
+	{
+		if (mapping.Data)
+		{
+			munmap(mapping.Data, mapping.Size);
+		}
+
+		mapping = SFileMapping();
+	}
+
+	// Writes modified pages of the mapped region back to the file
+	FORCEINLINE static bool FlushMapping(const SFileMapping& mapping, bool wait)
+	{
+		return !mapping.Data || msync(mapping.Data, mapping.Size, wait ? MS_SYNC : MS_ASYNC) == 0;
+	}
+
+private:
+
+	template<typename FuncT>
+	static int64 VectoredImpl(const SFileSlice* slices, int32 num, int64 offset, FuncT&& func)
+	{
+		iovec vectors[MAX_SLICES];
+
+		int64 total = 0;
+		for (int32 first = 0; first < num; first += MAX_SLICES)
+		{
+			const int32 batchNum = FillVectorsImpl(vectors, slices + first, num - first);
+
+			int64 batchSize = 0;
+			for (int32 i = 0; i < batchNum; ++i)
+			{
+				batchSize += vectors[i].iov_len;
+			}
+
+			ssize_t result;
+			do { result = func(vectors, batchNum, offset + total); } while (result < 0 && errno == EINTR);
+			if (result < 0) return total > 0 ? total : result;
+
+			total += result;
+			if (result < batchSize) break;
+		}
+
+		return total;
+	}
+
+	FORCEINLINE static int32 FillVectorsImpl(iovec* vectors, const SFileSlice* slices, int32 num)
+	{
+		num = num < MAX_SLICES ? num : MAX_SLICES;
+		for (int32 i = 0; i < num; ++i)
+		{
+			vectors[i].iov_base = slices[i].Data;
+			vectors[i].iov_len = slices[i].Size;
+		}
+
+		return num;
+	}
+};
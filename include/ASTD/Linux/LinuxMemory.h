@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdlib>
+#include <malloc.h>
 #include <memory.h>
 
 #include "ASTD/Linux/LinuxBuild.h"
@@ -23,6 +25,44 @@ struct SLinuxPlatformMemory
 	// Deallocates memory
 	FORCEINLINE static void Free(void* ptr) { return free(ptr); }
 
+	// Allocates new memory aligned to "alignment" (power of two), has to be freed by FreeAligned
+	FORCEINLINE static void* MallocAligned(int64 size, int64 alignment)
+	{
+		void* ptr = nullptr;
+		return posix_memalign(&ptr, alignment < (int64)sizeof(void*) ? sizeof(void*) : alignment, size) == 0 ? ptr : nullptr;
+	}
+
+	// Reallocates aligned memory, on failure returns nullptr and "ptr" stays valid (same as realloc)
+	static void* ReallocAligned(void* ptr, int64 size, int64 alignment)
+	{
+		if (!ptr) return MallocAligned(size, alignment);
+
+		// Alignment malloc guarantees anyway, realloc can grow in place
+		if (alignment <= (int64)alignof(std::max_align_t))
+		{
+			return realloc(ptr, size);
+		}
+
+		// Over-aligned, realloc could move to misaligned block after freeing the only copy
+		const int64 oldSize = (int64)malloc_usable_size(ptr);
+		if (oldSize >= size)
+		{
+			return ptr;
+		}
+
+		void* alignedPtr = MallocAligned(size, alignment);
+		if (alignedPtr)
+		{
+			memcpy(alignedPtr, ptr, oldSize);
+			free(ptr);
+		}
+
+		return alignedPtr;
+	}
+
+	// Deallocates memory allocated by MallocAligned
+	FORCEINLINE static void FreeAligned(void* ptr) { return free(ptr); }
+
 	// Copies block of memory from destionation to source (does not handle overlapping)
 	FORCEINLINE static void* Copy(void* dest, const void* src, int64 size) { return memcpy(dest, src, size); }
 
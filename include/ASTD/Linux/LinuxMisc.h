@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <cerrno>
+#include <sys/uio.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -9,10 +11,11 @@
 
 struct SLinuxPlatformMisc
 {
+	// Gets wall clock time in seconds since epoch, see STime for precise integer clocks
 	static double GetSecondsSinceEpoch()
 	{
 		timespec ts;
-		clock_gettime(CLOCK_MONOTONIC, &ts);
+		clock_gettime(CLOCK_REALTIME, &ts);
 
 		return (double)ts.tv_sec + (double)ts.tv_nsec / 1.e9;
 	}
@@ -22,4 +25,49 @@ struct SLinuxPlatformMisc
 
 	// Writes to standard file by fileno. example: STDOUT_FILENO
 	FORCEINLINE static int64 WriteStd(int32 fileNo, const void* buffer, uint64 size) { return write(fileNo, buffer, size); }
+
+	// Writes multiple buffers to standard file by fileno at once
+	// * Retries partial writes, returns number of written bytes or -1 on error
+	static int64 WriteStdBuffers(int32 fileNo, const void* const* buffers, const uint64* sizes, int32 num)
+	{
+		constexpr int32 MAX_BATCH_NUM = 64;
+		iovec vectors[MAX_BATCH_NUM];
+
+		int64 totalWritten = 0;
+		int32 idx = 0;
+		uint64 idxOffset = 0;
+		while (idx < num)
+		{
+			int32 batchNum = 0;
+			for (int32 i = idx; i < num && batchNum < MAX_BATCH_NUM; ++i)
+			{
+				const uint64 offset = i == idx ? idxOffset : 0;
+				vectors[batchNum].iov_base = (uint8*)buffers[i] + offset;
+				vectors[batchNum].iov_len = sizes[i] - offset;
+				++batchNum;
+			}
+
+			const ssize_t written = writev(fileNo, vectors, batchNum);
+			if (written < 0)
+			{
+				if (errno == EINTR) continue;
+				return -1;
+			}
+
+			totalWritten += written;
+
+			// Skips fully written buffers
+			uint64 remaining = (uint64)written;
+			while (idx < num && remaining >= sizes[idx] - idxOffset)
+			{
+				remaining -= sizes[idx] - idxOffset;
+				idxOffset = 0;
+				++idx;
+			}
+
+			idxOffset += remaining;
+		}
+
+		return totalWritten;
+	}
 };
@@ -0,0 +1,32 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include <time.h>
+
+#include "ASTD/Linux/LinuxBuild.h"
+
+struct SLinuxPlatformTime
+{
+	// Gets monotonic time in nanoseconds, starting point is unspecified
+	FORCEINLINE static int64 GetMonotonicNanoseconds() { return GetClockImpl(CLOCK_MONOTONIC); }
+
+	// Gets monotonic time in nanoseconds, cheap but with precision of few milliseconds
+	FORCEINLINE static int64 GetCoarseMonotonicNanoseconds() { return GetClockImpl(CLOCK_MONOTONIC_COARSE); }
+
+	// Gets wall clock time in nanoseconds since epoch
+	FORCEINLINE static int64 GetWallNanoseconds() { return GetClockImpl(CLOCK_REALTIME); }
+
+	// Gets wall clock time in nanoseconds since epoch, cheap but with precision of few milliseconds
+	FORCEINLINE static int64 GetCoarseWallNanoseconds() { return GetClockImpl(CLOCK_REALTIME_COARSE); }
+
+private:
+
+	FORCEINLINE static int64 GetClockImpl(clockid_t clock)
+	{
+		timespec ts;
+		clock_gettime(clock, &ts);
+
+		return (int64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	}
+};
@@ -0,0 +1,308 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/Array.h"
+#include "ASTD/Memory.h"
+#include "ASTD/Misc.h"
+#include "ASTD/Time.h"
+
+// TODO: Replace with custom implementation
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+
+// Severity of log, lower is more severe
+enum class ELogLevel : uint8
+{
+	Fatal = 0,
+	Error,
+	Warning,
+	Display,
+	Log,
+	Verbose,
+	VeryVerbose
+};
+
+// Named group of logs with its own level
+// * Use DECLARE_LOG_CATEGORY instead of using it directly
+struct SLogCategory
+{
+	FORCEINLINE SLogCategory(const tchar* name, ELogLevel level)
+		: _name(name)
+		, _level((uint8)level)
+	{}
+
+	SLogCategory(const SLogCategory&) = delete;
+	SLogCategory& operator=(const SLogCategory&) = delete;
+
+	FORCEINLINE const tchar* GetName() const { return _name; }
+
+	FORCEINLINE ELogLevel GetLevel() const { return (ELogLevel)_level.load(std::memory_order_relaxed); }
+	FORCEINLINE void SetLevel(ELogLevel level) { _level.store((uint8)level, std::memory_order_relaxed); }
+
+	FORCEINLINE bool IsEnabled(ELogLevel level) const { return (uint8)level <= _level.load(std::memory_order_relaxed); }
+
+private:
+
+	const tchar* _name;
+	std::atomic<uint8> _level;
+};
+
+// Declares log category usable with LOG macro
+// * "level" is the initial runtime level, "compileLevel" is the most verbose level that gets compiled in
+// * Example: DECLARE_LOG_CATEGORY(LogNetwork, Log, Verbose)
+#define DECLARE_LOG_CATEGORY(name, level, compileLevel)							\
+	struct SLogCategory_##name : public SLogCategory							\
+	{																			\
+		static constexpr ELogLevel COMPILE_LEVEL = ELogLevel::compileLevel;		\
+		FORCEINLINE SLogCategory_##name()										\
+			: SLogCategory(TEXT(#name), ELogLevel::level)						\
+		{}																		\
+	};																			\
+	inline SLogCategory_##name name;
+
+// Whether log of the level is compiled in and enabled
+#define LOG_ENABLED(category, level)											\
+	(SLog::IsCompiledIn<decltype(category)>(ELogLevel::level) && category.IsEnabled(ELogLevel::level))
+
+// Logs printf formatted message
+// * Arguments are not evaluated when the log is disabled, statement is removed completely when it is not compiled in
+// * Example: LOG(LogNetwork, Warning, TEXT("Connection lost after %d ms"), elapsedMs)
+#define LOG(category, level, ...)												\
+	do																			\
+	{																			\
+		if constexpr (SLog::IsCompiledIn<decltype(category)>(ELogLevel::level))	\
+		{																		\
+			if (category.IsEnabled(ELogLevel::level))							\
+			{																	\
+				SLog::Write(category, ELogLevel::level, __VA_ARGS__);			\
+			}																	\
+		}																		\
+	}																			\
+	while (0)
+
+// Logging entry point
+// * Message is formatted into per-thread buffer and passed to every sink with single write
+// * When there are no sinks, Error and Fatal go to stderr and everything else to stdout
+// * Sinks written from multiple threads have to be thread-safe (ex. SAsyncStdoutArchive)
+// * Fatal log flushes sinks and aborts the process
+struct SLog
+{
+	static constexpr int32 MAX_SINKS = 8;
+
+	template<typename CategoryT>
+	FORCEINLINE static constexpr bool IsCompiledIn(ELogLevel level)
+	{
+		return (int32)level <= ASTD_LOG_COMPILE_LEVEL && level <= CategoryT::COMPILE_LEVEL;
+	}
+
+	// Sinks
+	/////////////////////////////////
+
+	// Registers archive as log output, archive has to outlive its registration
+	static bool AddSink(SArchive& ar)
+	{
+		for (std::atomic<SArchive*>& sink : GetSinksImpl())
+		{
+			SArchive* expected = nullptr;
+			if (sink.compare_exchange_strong(expected, &ar))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Unregisters archive, caller has to make sure no other thread is logging to it
+	static void RemoveSink(SArchive& ar)
+	{
+		for (std::atomic<SArchive*>& sink : GetSinksImpl())
+		{
+			SArchive* expected = &ar;
+			sink.compare_exchange_strong(expected, nullptr);
+		}
+	}
+
+	static void Flush()
+	{
+		for (std::atomic<SArchive*>& sink : GetSinksImpl())
+		{
+			if (SArchive* ar = sink.load(std::memory_order_acquire))
+			{
+				ar->Flush();
+			}
+		}
+	}
+
+	// Writing
+	/////////////////////////////////
+
+	template<typename... ArgTypes>
+	static void Write(const SLogCategory& category, ELogLevel level, const tchar* fmt, ArgTypes&&... args)
+	{
+		TArray<tchar>& buffer = GetBufferImpl();
+		const int32 headerNum = WriteHeaderImpl(buffer.GetData(), category, level);
+
+		// Format is always parsed, so "%%" means the same with and without arguments
+		int32 messageNum = FormatImpl(buffer.GetData() + headerNum, buffer.GetNum() - headerNum, fmt, args...);
+		while (messageNum >= buffer.GetNum() - headerNum)
+		{
+			// Formatting does not consume arguments, so it can be repeated with bigger buffer
+			EnsureCapacityImpl(buffer, headerNum + messageNum + 1);
+			messageNum = FormatImpl(buffer.GetData() + headerNum, buffer.GetNum() - headerNum, fmt, args...);
+		}
+
+		if (messageNum < 0)
+		{
+			messageNum = 0;
+		}
+
+		buffer[headerNum + messageNum] = CHAR_NEWLINE;
+		WriteLineImpl(buffer.GetData(), headerNum + messageNum + 1, level);
+
+		if (level == ELogLevel::Fatal)
+		{
+			Flush();
+			abort();
+		}
+	}
+
+	// Helpers
+	/////////////////////////////////
+
+	static const tchar* GetLevelName(ELogLevel level)
+	{
+		switch (level)
+		{
+			case ELogLevel::Fatal: return TEXT("Fatal");
+			case ELogLevel::Error: return TEXT("Error");
+			case ELogLevel::Warning: return TEXT("Warning");
+			case ELogLevel::Display: return TEXT("Display");
+			case ELogLevel::Log: return TEXT("Log");
+			case ELogLevel::Verbose: return TEXT("Verbose");
+			case ELogLevel::VeryVerbose: return TEXT("VeryVerbose");
+			default: return TEXT("Unknown");
+		}
+	}
+
+private:
+
+	// Header "[HH:MM:SS.mmm][Category][Level] " always fits into initial buffer
+	static constexpr int32 INITIAL_BUFFER_NUM = 1024;
+	static constexpr int32 MAX_NAME_NUM = 64;
+	static constexpr int32 MAX_MESSAGE_NUM = 1 << 20;
+
+	static std::atomic<SArchive*> (&GetSinksImpl())[MAX_SINKS]
+	{
+		static std::atomic<SArchive*> sinks[MAX_SINKS] = {};
+		return sinks;
+	}
+
+	static TArray<tchar>& GetBufferImpl()
+	{
+		thread_local TArray<tchar> buffer;
+		if (buffer.IsEmpty())
+		{
+			buffer.AddUninitialized(INITIAL_BUFFER_NUM);
+		}
+
+		return buffer;
+	}
+
+	FORCEINLINE static void EnsureCapacityImpl(TArray<tchar>& buffer, int32 num)
+	{
+		if (buffer.GetNum() < num)
+		{
+			buffer.AddUninitialized(num - buffer.GetNum());
+		}
+	}
+
+	template<typename... ArgTypes>
+	FORCEINLINE static int32 FormatImpl(tchar* buffer, int64 num, const tchar* fmt, ArgTypes&... args)
+	{
+		if constexpr (TIsSame<tchar, wchar>::Value)
+		{
+			// Does not report required size, so buffer is grown till message fits
+			const int32 result = swprintf(buffer, num, fmt, args...);
+			return (result < 0 && num < MAX_MESSAGE_NUM) ? (int32)(num * 2) : result;
+		}
+		else
+		{
+			return snprintf(buffer, num, fmt, args...);
+		}
+	}
+
+	// Writes header and returns its length, category name is cut so it always fits
+	static int32 WriteHeaderImpl(tchar* buffer, const SLogCategory& category, ELogLevel level)
+	{
+		// Cheap clock, time of day is derived without calendar conversion (UTC)
+		const int64 ms = STime::NanosecondsToMilliseconds(STime::GetCoarseWallNanoseconds());
+		const int64 dayMs = ms % (24 * 60 * 60 * 1000);
+
+		int32 num = 0;
+		buffer[num++] = TEXT('[');
+		num = WriteDigitsImpl(buffer, num, dayMs / (60 * 60 * 1000), 2);
+		buffer[num++] = TEXT(':');
+		num = WriteDigitsImpl(buffer, num, dayMs / (60 * 1000) % 60, 2);
+		buffer[num++] = TEXT(':');
+		num = WriteDigitsImpl(buffer, num, dayMs / 1000 % 60, 2);
+		buffer[num++] = TEXT('.');
+		num = WriteDigitsImpl(buffer, num, dayMs % 1000, 3);
+		buffer[num++] = TEXT(']');
+
+		num = WriteNameImpl(buffer, num, category.GetName());
+		num = WriteNameImpl(buffer, num, GetLevelName(level));
+
+		buffer[num++] = TEXT(' ');
+		return num;
+	}
+
+	FORCEINLINE static int32 WriteDigitsImpl(tchar* buffer, int32 num, int64 value, int32 digits)
+	{
+		for (int32 i = digits - 1; i >= 0; --i)
+		{
+			buffer[num + i] = (tchar)(TEXT('0') + value % 10);
+			value /= 10;
+		}
+
+		return num + digits;
+	}
+
+	FORCEINLINE static int32 WriteNameImpl(tchar* buffer, int32 num, const tchar* name)
+	{
+		buffer[num++] = TEXT('[');
+		for (int32 i = 0; name[i] != CHAR_TERM && i < MAX_NAME_NUM; ++i)
+		{
+			buffer[num++] = name[i];
+		}
+
+		buffer[num++] = TEXT(']');
+		return num;
+	}
+
+	static void WriteLineImpl(const tchar* line, int32 num, ELogLevel level)
+	{
+		const int64 size = num * sizeof(tchar);
+
+		bool hasSink = false;
+		for (std::atomic<SArchive*>& sink : GetSinksImpl())
+		{
+			if (SArchive* ar = sink.load(std::memory_order_acquire))
+			{
+				ar->WriteBytes(line, size);
+				hasSink = true;
+			}
+		}
+
+		if (!hasSink)
+		{
+			SMisc::WriteStd(level <= ELogLevel::Error ? SMisc::STDERR_FILE_NO : SMisc::STDOUT_FILE_NO, line, size);
+		}
+	}
+};
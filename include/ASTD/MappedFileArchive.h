@@ -0,0 +1,203 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/File.h"
+#include "ASTD/Math.h"
+#include "ASTD/Memory.h"
+
+// File archive backed by memory mapping
+// * Read mode maps whole file read-only, data can be accessed without copies via GetView
+// * Write modes map file with spare capacity that grows geometrically, file is trimmed to written size on close
+struct SMappedFileArchive : public SArchive
+{
+	typedef SFile::HandleType HandleType;
+
+	static constexpr SizeType MIN_CAPACITY = 64 << 10; // 64 KiB
+
+	FORCEINLINE SMappedFileArchive(EArchiveType type, EArchiveMode mode, const tchar* filename, bool overwrite, SizeType initialCapacity = MIN_CAPACITY)
+		: SArchive(type, mode)
+	{
+		OpenImpl(filename, overwrite, initialCapacity);
+	}
+
+	FORCEINLINE virtual ~SMappedFileArchive() override
+	{
+		CloseImpl();
+	}
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE HandleType GetHandle() const { return _handle; }
+
+	// Gets number of bytes mapped (can be bigger than total bytes in write modes)
+	FORCEINLINE SizeType GetCapacity() const { return _mapping.Size; }
+
+	// Views
+	// * Returned pointers are invalidated by writes that grow the mapping
+	/////////////////////////////////
+
+	// Gets pointer into the mapping, nullptr when range is out of bounds
+	FORCEINLINE const uint8* GetView(SizeType offset, SizeType size) const
+	{
+		return (offset >= 0 && size >= 0 && offset + size <= _size) ? _mapping.Data + offset : nullptr;
+	}
+
+	// Gets typed pointer into the mapping, nullptr when range is out of bounds
+	// * Offset is in bytes, mapping does not guarantee alignment of T at arbitrary offsets
+	template<typename T>
+	FORCEINLINE const T* GetViewTyped(SizeType offset, SizeType num) const
+	{
+		return reinterpret_cast<const T*>(GetView(offset, num * (SizeType)sizeof(T)));
+	}
+
+	// Gets view from current offset and moves past it, nullptr when not enough bytes remain
+	FORCEINLINE const uint8* ReadView(SizeType size)
+	{
+		const uint8* view = GetView(_offset, size);
+		if (view) _offset += size;
+		return view;
+	}
+
+	// Durability
+	/////////////////////////////////
+
+	// Writes modified pages and waits for completion
+	FORCEINLINE bool Sync() { return SFile::FlushMapping(_mapping, true); }
+
+	// SArchive overrides
+	/////////////////////////////////
+
+	FORCEINLINE virtual bool IsValid() const override { return SFile::IsValidHandle(_handle); }
+
+	// Schedules write of modified pages
+	FORCEINLINE virtual void Flush() override { SFile::FlushMapping(_mapping, false); }
+
+	FORCEINLINE virtual SizeType GetTotalBytes() const override { return _size; }
+	FORCEINLINE virtual SizeType GetBytesOffset() const override { return _offset; }
+
+	FORCEINLINE virtual bool SetBytesOffset(SizeType offset) override
+	{
+		if (offset < 0 || offset > _size) return false;
+
+		_offset = offset;
+		return true;
+	}
+
+	virtual SizeType ReadBytes(void* ptr, SizeType size) override
+	{
+		if (!ptr || size <= 0) return 0;
+		else if (!AllowsRead() || !IsValid()) return 0;
+
+		const SizeType readBytes = SMath::Min(size, _size - _offset);
+		if (readBytes > 0)
+		{
+			SMemory::Copy(ptr, _mapping.Data + _offset, readBytes);
+			_offset += readBytes;
+		}
+
+		return readBytes > 0 ? readBytes : 0;
+	}
+
+	virtual SizeType WriteBytes(const void* ptr, SizeType size) override
+	{
+		if (!ptr || size <= 0) return 0;
+		else if (!AllowsWrite() || !IsValid()) return 0;
+		else if (!ReserveImpl(_offset + size)) return 0;
+
+		SMemory::Copy(_mapping.Data + _offset, ptr, size);
+
+		_offset += size;
+		_size = SMath::Max(_size, _offset);
+
+		return size;
+	}
+
+private:
+
+	void OpenImpl(const tchar* filename, bool overwrite, SizeType initialCapacity)
+	{
+		uint32 flags = EFileOpenFlags::Read;
+		switch (GetMode())
+		{
+			case EArchiveMode::Read:
+			break;
+			case EArchiveMode::Write:
+				// Shared writable mapping requires read access as well
+				flags |= EFileOpenFlags::Write | EFileOpenFlags::Create | EFileOpenFlags::Truncate;
+			break;
+			case EArchiveMode::ReadWrite:
+				flags |= EFileOpenFlags::Write | EFileOpenFlags::Create;
+				if (overwrite) flags |= EFileOpenFlags::Truncate;
+			break;
+		}
+
+		_handle = SFile::Open(filename, flags);
+		if (!IsValid())
+		{
+			return;
+		}
+
+		_size = SMath::Max<SizeType>(SFile::GetSize(_handle), 0);
+
+		if (AllowsWrite())
+		{
+			ReserveImpl(SMath::Max(initialCapacity, _size));
+		}
+		else if (_size > 0 && !SFile::Map(_handle, _size, false, _mapping))
+		{
+			CloseImpl();
+		}
+	}
+
+	void CloseImpl()
+	{
+		SFile::Unmap(_mapping);
+
+		if (IsValid())
+		{
+			if (AllowsWrite())
+			{
+				// Removes spare capacity
+				SFile::Truncate(_handle, _size);
+			}
+
+			SFile::Close(_handle);
+			_handle = SFile::INVALID_HANDLE;
+		}
+	}
+
+	bool ReserveImpl(SizeType capacity)
+	{
+		if (capacity <= _mapping.Size)
+		{
+			return true;
+		}
+
+		SizeType newCapacity = SMath::Max<SizeType>(_mapping.Size, MIN_CAPACITY);
+		while (newCapacity < capacity)
+		{
+			newCapacity *= 2;
+		}
+
+		SFile::Unmap(_mapping);
+		if (!SFile::Truncate(_handle, newCapacity))
+		{
+			// Try to restore previous mapping
+			if (_size > 0) SFile::Map(_handle, _size, true, _mapping);
+			return false;
+		}
+
+		return SFile::Map(_handle, newCapacity, true, _mapping);
+	}
+
+	HandleType _handle = SFile::INVALID_HANDLE;
+	SFileMapping _mapping = {};
+
+	SizeType _offset = 0;
+	SizeType _size = 0;
+};
@@ -0,0 +1,301 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Math.h"
+#include "ASTD/Memory.h"
+
+// Bump-pointer (linear) allocator
+// * Allocation only moves offset inside current chunk, new chunk is allocated when it does not fit
+// * Memory is given back all at once (Reset, Rewind), destructors of allocated objects are never called
+// * Not thread-safe, use per-thread arena (GetThreadArena) or external synchronization
+struct SMemArena
+{
+	static constexpr int64 DEFAULT_CHUNK_SIZE = 64 << 10; // 64 KiB
+	static constexpr int64 MAX_CHUNK_SIZE = 16 << 20; // 16 MiB
+	static constexpr int64 DEFAULT_ALIGNMENT = 16;
+
+	// Position in arena, see GetMarker and Rewind
+	struct SMarker
+	{
+		void* Chunk;
+		int64 Offset;
+	};
+
+	// Constructors
+	/////////////////////////////////
+
+	FORCEINLINE explicit SMemArena(int64 chunkSize = DEFAULT_CHUNK_SIZE)
+		: _chunkSize(SMath::Max<int64>(chunkSize, 256))
+	{}
+
+	SMemArena(const SMemArena&) = delete;
+	SMemArena& operator=(const SMemArena&) = delete;
+
+	// Destructor
+	/////////////////////////////////
+
+	FORCEINLINE ~SMemArena() { ReleaseMemory(); }
+
+	// Allocation
+	/////////////////////////////////
+
+	// Allocates memory, alignment has to be power of two
+	FORCEINLINE void* Allocate(int64 size, int64 alignment = DEFAULT_ALIGNMENT)
+	{
+		if (_current)
+		{
+			uint8* data = GetChunkDataImpl(_current);
+			const int64 offset = AlignImpl((int64)(data + _offset), alignment) - (int64)data;
+			if (offset + size <= _current->Size)
+			{
+				_offset = offset + size;
+				_last = data + offset;
+				return _last;
+			}
+		}
+
+		return AllocateSlowImpl(size, alignment);
+	}
+
+	template<typename T>
+	FORCEINLINE T* AllocateTyped(int64 num = 1)
+	{
+		return (T*)Allocate(num * sizeof(T), alignof(T) > DEFAULT_ALIGNMENT ? alignof(T) : DEFAULT_ALIGNMENT);
+	}
+
+	// Constructs object in arena, its destructor is never called
+	template<typename T, typename... ArgTypes>
+	FORCEINLINE T* New(ArgTypes&&... args)
+	{
+		return ::new((void*)AllocateTyped<T>()) T(Forward<ArgTypes>(args)...);
+	}
+
+	// Grows/shrinks allocation in place when it is the last one, otherwise allocates new block and copies the data
+	void* Reallocate(void* ptr, int64 oldSize, int64 newSize, int64 alignment = DEFAULT_ALIGNMENT)
+	{
+		if (!ptr) return Allocate(newSize, alignment);
+
+		if (ptr == _last)
+		{
+			const int64 offset = (uint8*)ptr - GetChunkDataImpl(_current);
+			if (offset + newSize <= _current->Size)
+			{
+				_offset = offset + newSize;
+				return ptr;
+			}
+		}
+
+		void* newPtr = Allocate(newSize, alignment);
+		SMemory::Copy(newPtr, ptr, SMath::Min(oldSize, newSize));
+		return newPtr;
+	}
+
+	// Gives memory back only when it is the last allocation, otherwise it waits for Reset/Rewind
+	FORCEINLINE void Free(void* ptr, int64)
+	{
+		if (ptr && ptr == _last)
+		{
+			_offset = (uint8*)ptr - GetChunkDataImpl(_current);
+			_last = nullptr;
+		}
+	}
+
+	// Markers
+	/////////////////////////////////
+
+	FORCEINLINE SMarker GetMarker() const { return { _current, _offset }; }
+
+	// Frees everything allocated after the marker was taken
+	FORCEINLINE void Rewind(const SMarker& marker)
+	{
+		_current = (SChunk*)marker.Chunk;
+		_offset = marker.Offset;
+		_last = nullptr;
+
+		if (!_current)
+		{
+			Reset();
+		}
+	}
+
+	// Frees everything in O(1), chunks are kept for reuse
+	FORCEINLINE void Reset()
+	{
+		_current = _first;
+		_offset = 0;
+		_last = nullptr;
+	}
+
+	// Frees everything and gives chunks back to the system
+	void ReleaseMemory()
+	{
+		SChunk* chunk = _first;
+		while (chunk)
+		{
+			SChunk* next = chunk->Next;
+			SMemory::Free(chunk);
+			chunk = next;
+		}
+
+		_first = nullptr;
+		_current = nullptr;
+		_offset = 0;
+		_last = nullptr;
+	}
+
+	// Getters
+	/////////////////////////////////
+
+	// Gets number of bytes handed out since last reset (including alignment padding)
+	int64 GetUsedBytes() const
+	{
+		if (!_current) return 0;
+
+		int64 bytes = _offset;
+		for (SChunk* chunk = _first; chunk != _current; chunk = chunk->Next)
+		{
+			bytes += chunk->Size;
+		}
+
+		return bytes;
+	}
+
+	// Gets number of bytes held by chunks
+	int64 GetReservedBytes() const
+	{
+		int64 bytes = 0;
+		for (SChunk* chunk = _first; chunk; chunk = chunk->Next)
+		{
+			bytes += chunk->Size;
+		}
+
+		return bytes;
+	}
+
+	// Per-thread arenas
+	/////////////////////////////////
+
+	// Gets arena owned by calling thread
+	static SMemArena& GetThreadArena()
+	{
+		thread_local SMemArena arena;
+		return arena;
+	}
+
+	// Gets arena used by arena allocators created on calling thread
+	// * Thread arena unless other arena is made current by SMemArenaScope
+	FORCEINLINE static SMemArena& GetCurrent()
+	{
+		SMemArena* current = GetCurrentImpl();
+		return current ? *current : GetThreadArena();
+	}
+
+private:
+
+	friend struct SMemArenaScope;
+
+	// Header placed at the beginning of each chunk
+	struct SChunk
+	{
+		SChunk* Next;
+		int64 Size;
+	};
+
+	static constexpr int64 CHUNK_HEADER_SIZE = (sizeof(SChunk) + DEFAULT_ALIGNMENT - 1) & ~(DEFAULT_ALIGNMENT - 1);
+
+	FORCEINLINE static int64 AlignImpl(int64 offset, int64 alignment) { return (offset + alignment - 1) & ~(alignment - 1); }
+	FORCEINLINE static uint8* GetChunkDataImpl(SChunk* chunk) { return (uint8*)chunk + CHUNK_HEADER_SIZE; }
+
+	static SMemArena*& GetCurrentImpl()
+	{
+		thread_local SMemArena* current = nullptr;
+		return current;
+	}
+
+	void* AllocateSlowImpl(int64 size, int64 alignment)
+	{
+		// Chunk data is aligned at least to DEFAULT_ALIGNMENT, bigger alignment may need padding
+		const int64 requiredSize = size + (alignment > DEFAULT_ALIGNMENT ? alignment : 0);
+
+		// Reuses chunks kept by Reset/Rewind, the ones that are too small are skipped
+		SChunk* chunk = _current ? _current->Next : _first;
+		while (chunk && chunk->Size < requiredSize)
+		{
+			chunk = chunk->Next;
+		}
+
+		if (!chunk)
+		{
+			// Chunks grow with arena, so big arenas do not end up with long chains
+			int64 chunkSize = _current ? SMath::Min(_current->Size * 2, MAX_CHUNK_SIZE) : _chunkSize;
+			chunkSize = SMath::Max(chunkSize, requiredSize);
+
+			chunk = (SChunk*)SMemory::Malloc(CHUNK_HEADER_SIZE + chunkSize);
+			chunk->Size = chunkSize;
+
+			// Inserted after current chunk, so it is reused in the same order after Reset
+			if (_current)
+			{
+				chunk->Next = _current->Next;
+				_current->Next = chunk;
+			}
+			else
+			{
+				chunk->Next = _first;
+				_first = chunk;
+			}
+		}
+
+		_current = chunk;
+
+		uint8* data = GetChunkDataImpl(chunk);
+		const int64 offset = AlignImpl((int64)data, alignment) - (int64)data;
+		_offset = offset + size;
+		_last = data + offset;
+		return _last;
+	}
+
+	SChunk* _first = nullptr;
+	SChunk* _current = nullptr;
+	int64 _offset = 0;
+	void* _last = nullptr;
+	int64 _chunkSize = DEFAULT_CHUNK_SIZE;
+};
+
+// Makes arena current for calling thread till the end of scope
+// * Arena allocators (TArenaAllocator, SQueueArenaMemory) take memory from current arena
+// * When "rewind" is set, everything allocated inside the scope is freed at its end
+struct SMemArenaScope
+{
+	FORCEINLINE explicit SMemArenaScope(SMemArena& arena, bool rewind = false)
+		: _arena(arena)
+		, _previous(SMemArena::GetCurrentImpl())
+		, _marker(arena.GetMarker())
+		, _rewind(rewind)
+	{
+		SMemArena::GetCurrentImpl() = &arena;
+	}
+
+	SMemArenaScope(const SMemArenaScope&) = delete;
+	SMemArenaScope& operator=(const SMemArenaScope&) = delete;
+
+	FORCEINLINE ~SMemArenaScope()
+	{
+		SMemArena::GetCurrentImpl() = _previous;
+
+		if (_rewind)
+		{
+			_arena.Rewind(_marker);
+		}
+	}
+
+private:
+
+	SMemArena& _arena;
+	SMemArena* _previous;
+	SMemArena::SMarker _marker;
+	bool _rewind;
+};
@@ -4,9 +4,15 @@
 
 #include "ASTDMinimal.h"
 
+#include <cstddef>
+#include <cstdlib>
 #include <new>
 #include PLATFORM_HEADER(Memory)
 
+#if ASTD_SMALL_ALLOCATOR
+	#include "ASTD/_internal/SmallAllocator.h"
+#endif
+
 typedef PLATFORM_PREFIXED_TYPE(S, PlatformMemory) SPlatformMemory;
 struct SMemory : public SPlatformMemory
 {
@@ -24,22 +30,103 @@ struct SMemory : public SPlatformMemory
 	static constexpr long double Tb_PER_BYTE = 7.e-12; // terabits
 	static constexpr long double TB_PER_BYTE = 1.e-12; // terabytes
 
+#if ASTD_SMALL_ALLOCATOR
+	// Allocations are served by small object allocator. See SmallAllocator.h
+	typedef _NMemory::SSmallAllocator AllocatorType;
+#else
+	typedef SPlatformMemory AllocatorType;
+#endif
+
+	// Allocation counters of single thread, see ASTD_TRACK_MEMORY
+	struct SStats
+	{
+		int64 AllocationsNum = 0;
+		int64 ReallocationsNum = 0;
+		int64 FreesNum = 0;
+		int64 AllocatedBytes = 0;
+	};
+
+	static constexpr bool IS_TRACKING = ASTD_TRACK_MEMORY;
+
+	// Gets counters of calling thread, they are always zero when tracking is disabled
+	FORCEINLINE static SStats GetThreadStats() { return GetThreadStatsImpl(); }
+
+	// Allocation
+	/////////////////////////////////
+
+	FORCEINLINE static void* Malloc(int64 size)
+	{
+		TrackImpl(size, 1, 0, 0);
+		return AllocatorType::Malloc(size);
+	}
+
+	FORCEINLINE static void* Calloc(int64 size)
+	{
+		TrackImpl(size, 1, 0, 0);
+		return AllocatorType::Calloc(size);
+	}
+
+	FORCEINLINE static void* Realloc(void* ptr, int64 size)
+	{
+		TrackImpl(size, ptr ? 0 : 1, ptr ? 1 : 0, 0);
+		return AllocatorType::Realloc(ptr, size);
+	}
+
+	FORCEINLINE static void Free(void* ptr)
+	{
+		TrackImpl(0, 0, 0, ptr ? 1 : 0);
+		AllocatorType::Free(ptr);
+	}
+
+	FORCEINLINE static void* MallocAligned(int64 size, int64 alignment)
+	{
+		TrackImpl(size, 1, 0, 0);
+		return SPlatformMemory::MallocAligned(size, alignment);
+	}
+
+	FORCEINLINE static void* ReallocAligned(void* ptr, int64 size, int64 alignment)
+	{
+		TrackImpl(size, ptr ? 0 : 1, ptr ? 1 : 0, 0);
+		return SPlatformMemory::ReallocAligned(ptr, size, alignment);
+	}
+
+	FORCEINLINE static void FreeAligned(void* ptr)
+	{
+		TrackImpl(0, 0, 0, ptr ? 1 : 0);
+		SPlatformMemory::FreeAligned(ptr);
+	}
+
 	template<typename T>
 	FORCEINLINE static T* MallocTyped(int64 num = 1)
 	{
-		return (T*)SPlatformMemory::Malloc(num * sizeof(T));
+		return (T*)Malloc(num * sizeof(T));
 	}
 
 	template<typename T>
 	FORCEINLINE static T* ReallocTyped(T* ptr, int64 num = 1)
 	{
-		return (T*)SPlatformMemory::Realloc(ptr, num * sizeof(T));
+		return (T*)Realloc(ptr, num * sizeof(T));
+	}
+
+	// Default alignment of Malloc, bigger alignment needs MallocAligned
+	static constexpr int64 DEFAULT_ALIGNMENT = alignof(std::max_align_t);
+
+	template<typename T>
+	FORCEINLINE static T* MallocAlignedTyped(int64 num = 1, int64 alignment = alignof(T))
+	{
+		return (T*)MallocAligned(num * sizeof(T), alignment);
+	}
+
+	template<typename T>
+	FORCEINLINE static T* ReallocAlignedTyped(T* ptr, int64 num = 1, int64 alignment = alignof(T))
+	{
+		return (T*)ReallocAligned(ptr, num * sizeof(T), alignment);
 	}
 
 	template<typename T>
 	FORCEINLINE static T* CallocTyped(int64 num = 1)
 	{
-		return (T*)SPlatformMemory::Calloc(num * sizeof(T));
+		return (T*)Calloc(num * sizeof(T));
 	}
 
 	template<typename T>
@@ -70,7 +157,7 @@ struct SMemory : public SPlatformMemory
 	{
 		if constexpr (!TTypeTraits<T>::IsBitwiseMovable)
 		{
-			::new((void*)to) T(*from);
+			::new((void*)to) T(::Move(*from));
 		}
 		else
 		{
@@ -82,6 +169,34 @@ struct SMemory : public SPlatformMemory
 		}
 	}
 
+	// Moves elements to another (possibly overlapping) memory
+	// * Source is left uninitialized, elements are not destructed twice
+	template<typename T>
+	static void RelocateTyped(T* to, T* from, int64 num = 1)
+	{
+		if (to == from || num <= 0) return;
+
+		if constexpr (!TIsBitwiseRelocatable<T>::Value)
+		{
+			// Order matters when memory overlaps
+			const bool forward = to < from;
+			for (int64 i = 0; i < num; ++i)
+			{
+				const int64 idx = forward ? i : num - i - 1;
+				::new((void*)(to + idx)) T(::Move(from[idx]));
+				from[idx].~T();
+			}
+		}
+		else
+		{
+			SPlatformMemory::Move(
+				to,
+				from,
+				sizeof(T) * num
+			);
+		}
+	}
+
 	template<typename T>
 	FORCEINLINE static void FillTyped(const T* dst, T val, int64 num = 1)
 	{
@@ -104,7 +219,7 @@ struct SMemory : public SPlatformMemory
 	}
 
 	template<typename T>
-	FORCEINLINE static void ZeroTyped(const T* dst, int64 num = 1)
+	FORCEINLINE static void ZeroTyped(T* dst, int64 num = 1)
 	{
 		if constexpr (!TTypeTraits<T>::IsBitwiseCopyable)
 		{
@@ -144,14 +259,15 @@ struct SMemory : public SPlatformMemory
 				lhs,
 				rhs,
 				sizeof(T) * num
-			);
+			) == 0;
 		}
 	}
 
 	template<typename T, typename... ArgTypes>
 	FORCEINLINE static void Construct(T* ptr, ArgTypes&&... Args)
 	{
-		if constexpr (!TIsTriviallyConstructible<T, ArgTypes...>::Value)
+		// Only default construction is replaced by zeroing, arguments are always passed
+		if constexpr (sizeof...(ArgTypes) > 0 || !TIsTriviallyConstructible<T>::Value)
 		{
 			::new((void*)ptr) T(Forward<ArgTypes>(Args)...);
 		}
@@ -170,16 +286,75 @@ struct SMemory : public SPlatformMemory
 			ptr->~T();
 		}
 	}
+
+private:
+
+	FORCEINLINE static SStats& GetThreadStatsImpl()
+	{
+		thread_local SStats stats;
+		return stats;
+	}
+
+	// Per-thread counters, so tracking never contends between threads
+	FORCEINLINE static void TrackImpl(int64 bytes, int64 allocationsNum, int64 reallocationsNum, int64 freesNum)
+	{
+		if constexpr (IS_TRACKING)
+		{
+			SStats& stats = GetThreadStatsImpl();
+			stats.AllocatedBytes += bytes;
+			stats.AllocationsNum += allocationsNum;
+			stats.ReallocationsNum += reallocationsNum;
+			stats.FreesNum += freesNum;
+		}
+	}
 };
 
 #if ASTD_NEW_DELETE
-void* operator new(TSize size)
+// Every global new/delete form is replaced, so no pointer from SMemory ever reaches the CRT free (and vice versa)
+// Aligned forms go through MallocAligned/FreeAligned, as the small allocator does not honor extended alignment
+// Operators stay out of line, otherwise GCC sees the inlined malloc/free pairs and reports mismatched new/delete
+
+FORCEINLINE_DEBUGGABLE static void* NewImpl(TSize size) noexcept
 {
-	return SMemory::MallocTyped<uint8>((uint32)size);
+	return SMemory::Malloc(size > 0 ? (int64)size : 1);
 }
 
-void operator delete(void* ptr, TSize) noexcept
+FORCEINLINE_DEBUGGABLE static void* NewAlignedImpl(TSize size, std::align_val_t alignment) noexcept
 {
-	return SMemory::Free(ptr);
+	return SMemory::MallocAligned(size > 0 ? (int64)size : 1, (int64)alignment);
+}
+
+FORCEINLINE_DEBUGGABLE static void* NewCheckedImpl(void* ptr)
+{
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+	if (!ptr) throw std::bad_alloc();
+#else
+	if (!CHECKF(ptr)) std::abort();
+#endif
+	return ptr;
 }
+
+FORCENOINLINE void* operator new(TSize size) { return NewCheckedImpl(NewImpl(size)); }
+FORCENOINLINE void* operator new[](TSize size) { return NewCheckedImpl(NewImpl(size)); }
+FORCENOINLINE void* operator new(TSize size, const std::nothrow_t&) noexcept { return NewImpl(size); }
+FORCENOINLINE void* operator new[](TSize size, const std::nothrow_t&) noexcept { return NewImpl(size); }
+
+FORCENOINLINE void operator delete(void* ptr) noexcept { SMemory::Free(ptr); }
+FORCENOINLINE void operator delete[](void* ptr) noexcept { SMemory::Free(ptr); }
+FORCENOINLINE void operator delete(void* ptr, TSize) noexcept { SMemory::Free(ptr); }
+FORCENOINLINE void operator delete[](void* ptr, TSize) noexcept { SMemory::Free(ptr); }
+FORCENOINLINE void operator delete(void* ptr, const std::nothrow_t&) noexcept { SMemory::Free(ptr); }
+FORCENOINLINE void operator delete[](void* ptr, const std::nothrow_t&) noexcept { SMemory::Free(ptr); }
+
+FORCENOINLINE void* operator new(TSize size, std::align_val_t alignment) { return NewCheckedImpl(NewAlignedImpl(size, alignment)); }
+FORCENOINLINE void* operator new[](TSize size, std::align_val_t alignment) { return NewCheckedImpl(NewAlignedImpl(size, alignment)); }
+FORCENOINLINE void* operator new(TSize size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return NewAlignedImpl(size, alignment); }
+FORCENOINLINE void* operator new[](TSize size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return NewAlignedImpl(size, alignment); }
+
+FORCENOINLINE void operator delete(void* ptr, std::align_val_t) noexcept { SMemory::FreeAligned(ptr); }
+FORCENOINLINE void operator delete[](void* ptr, std::align_val_t) noexcept { SMemory::FreeAligned(ptr); }
+FORCENOINLINE void operator delete(void* ptr, TSize, std::align_val_t) noexcept { SMemory::FreeAligned(ptr); }
+FORCENOINLINE void operator delete[](void* ptr, TSize, std::align_val_t) noexcept { SMemory::FreeAligned(ptr); }
+FORCENOINLINE void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { SMemory::FreeAligned(ptr); }
+FORCENOINLINE void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { SMemory::FreeAligned(ptr); }
 #endif
@@ -8,7 +8,8 @@
 #include PLATFORM_HEADER(Misc)
 
 typedef PLATFORM_PREFIXED_TYPE(S, PlatformMisc) SPlatformMisc;
-// TODO: Separate to IO (input/output) and STime
+// TODO: Separate to IO (input/output)
+// * Clocks are in STime, see Time.h
 struct SMisc : public SPlatformMisc
 {
 	static constexpr long double NS_PER_SECOND = 1.e9; // nanoseconds
@@ -23,30 +24,30 @@ struct SMisc : public SPlatformMisc
 
 	FORCEINLINE_DEBUGGABLE static int64 ReadFromStdin(void* buffer, int64 size)
 	{
-		return SPlatformMisc::ReadFromFile(STDIN_FILE_NO, buffer, size);
+		return SPlatformMisc::ReadStd(STDIN_FILE_NO, buffer, size);
 	}
 
 	FORCEINLINE_DEBUGGABLE static int64 WriteToStdout(const void* buffer, int64 size)
 	{
-		return SPlatformMisc::WriteToFile(STDOUT_FILE_NO, buffer, size);
+		return SPlatformMisc::WriteStd(STDOUT_FILE_NO, buffer, size);
 	}
 
 	FORCEINLINE_DEBUGGABLE static int64 WriteToStderr(const void* buffer, int64 size)
 	{
-		return SPlatformMisc::WriteToFile(STDERR_FILE_NO, buffer, size);
+		return SPlatformMisc::WriteStd(STDERR_FILE_NO, buffer, size);
 	}
 
 	template<typename CharType, typename TEnableIf<TIsCharacter<CharType>::Value>::Type* = nullptr>
 	FORCEINLINE_DEBUGGABLE static uint64 WriteToStdout(const CharType* str)
 	{
-		const uint64 writtenBytes = SPlatformMisc::WriteToFile(STDOUT_FILE_NO, str, SCString::GetLength(str) * sizeof(CharType));
+		const uint64 writtenBytes = SPlatformMisc::WriteStd(STDOUT_FILE_NO, str, SCString::GetLength(str) * sizeof(CharType));
 		return writtenBytes >= sizeof(tchar) ? writtenBytes / sizeof(tchar) : 0;
 	}
 
 	template<typename CharType, typename TEnableIf<TIsCharacter<CharType>::Value>::Type* = nullptr>
 	FORCEINLINE_DEBUGGABLE static uint64 WriteToStderr(const CharType* str)
 	{
-		const uint64 writtenBytes = SPlatformMisc::WriteToFile(STDERR_FILE_NO, str, SCString::GetLength(str) * sizeof(CharType));
+		const uint64 writtenBytes = SPlatformMisc::WriteStd(STDERR_FILE_NO, str, SCString::GetLength(str) * sizeof(CharType));
 		return writtenBytes >= sizeof(tchar) ? writtenBytes / sizeof(tchar) : 0;
 	}
 };
@@ -7,9 +7,63 @@
 #include "ASTD/Memory.h"
 #include "ASTD/TypeTraits.h"
 
+namespace _NOptional
+{
+	struct SEmptyValue {};
+
+	// Value lives inside the optional, no allocation is ever made
+	// * Trivially destructible values keep storage trivially destructible, so optional can be used in constexpr
+	template<typename T, bool IsTrivial = TIsTriviallyDestructible<T>::Value>
+	struct TOptionalStorage
+	{
+		FORCEINLINE constexpr TOptionalStorage() : _empty(), _isSet(false) {}
+		FORCEINLINE constexpr explicit TOptionalStorage(const T& value) : _value(value), _isSet(true) {}
+		FORCEINLINE constexpr explicit TOptionalStorage(T&& value) : _value(Move(value)), _isSet(true) {}
+
+		union
+		{
+			SEmptyValue _empty;
+			T _value;
+		};
+
+		bool _isSet;
+	};
+
+	template<typename T>
+	struct TOptionalStorage<T, false>
+	{
+		FORCEINLINE TOptionalStorage() : _empty(), _isSet(false) {}
+		FORCEINLINE explicit TOptionalStorage(const T& value) : _value(value), _isSet(true) {}
+		FORCEINLINE explicit TOptionalStorage(T&& value) : _value(Move(value)), _isSet(true) {}
+
+		FORCEINLINE ~TOptionalStorage()
+		{
+			if (_isSet)
+			{
+				SMemory::Destruct(&_value);
+			}
+		}
+
+		union
+		{
+			SEmptyValue _empty;
+			T _value;
+		};
+
+		bool _isSet;
+	};
+}
+
+// Value that may or may not be set
+// * Value is stored inline with presence flag, setting it never allocates
 template<typename ElementT>
-class TOptional
+class TOptional : private _NOptional::TOptionalStorage<ElementT>
 {
+	typedef _NOptional::TOptionalStorage<ElementT> StorageType;
+
+	using StorageType::_value;
+	using StorageType::_isSet;
+
 public:
 
 	// Typedefs
@@ -25,16 +79,11 @@ public:
 	// Constructors
 	/////////////////////////////////
 
-	FORCEINLINE TOptional() = default;
-	FORCEINLINE TOptional(const TOptional& other) { FillToEmpty(other); }
-	FORCEINLINE TOptional(TOptional&& other) { FillToEmpty(Move(other)); }
-	FORCEINLINE TOptional(const ElementType& InValue) { FillToEmpty(InValue); }
-	FORCEINLINE TOptional(ElementType&& InValue) { FillToEmpty(Move(InValue)); }
-
-	// Destructor
-	/////////////////////////////////
-
-	FORCEINLINE ~TOptional() { Reset(); }
+	FORCEINLINE constexpr TOptional() = default;
+	FORCEINLINE TOptional(const TOptional& other) : StorageType() { FillToEmpty(other); }
+	FORCEINLINE TOptional(TOptional&& other) : StorageType() { FillToEmpty(Move(other)); }
+	FORCEINLINE constexpr TOptional(const ElementType& InValue) : StorageType(InValue) {}
+	FORCEINLINE constexpr TOptional(ElementType&& InValue) : StorageType(Move(InValue)) {}
 
 	// Comparison operators
 	/////////////////////////////////
@@ -45,8 +94,8 @@ public:
 	// Assign operators
 	/////////////////////////////////
 
-	FORCEINLINE TOptional& operator=(const TOptional& other) { Reset(); FillToEmpty(other); return *this; }
-	FORCEINLINE TOptional& operator=(TOptional&& other) noexcept { Reset(); FillToEmpty(Move(other)); return *this; }
+	FORCEINLINE TOptional& operator=(const TOptional& other) { if (&other != this) { Reset(); FillToEmpty(other); } return *this; }
+	FORCEINLINE TOptional& operator=(TOptional&& other) noexcept { if (&other != this) { Reset(); FillToEmpty(Move(other)); } return *this; }
 
 	FORCEINLINE TOptional& operator=(const ElementType& InValue) { Reset(); FillToEmpty(InValue); return *this; }
 	FORCEINLINE TOptional& operator=(ElementType&& InValue) { Reset(); FillToEmpty(Move(InValue)); return *this; }
@@ -54,25 +103,25 @@ public:
 	// Dereference operators
 	/////////////////////////////////
 
-	FORCEINLINE const ElementType* operator->() const { return _data; }
-	FORCEINLINE ElementType* operator->() { return _data; }
+	FORCEINLINE const ElementType* operator->() const { return &_value; }
+	FORCEINLINE ElementType* operator->() { return &_value; }
 
 	// Checks
 	/////////////////////////////////
 
-	FORCEINLINE bool IsValid() const { return !!_data; }
-	FORCEINLINE bool IsSet() const { return IsValid(); }
+	FORCEINLINE constexpr bool IsValid() const { return _isSet; }
+	FORCEINLINE constexpr bool IsSet() const { return IsValid(); }
 
 	// Getters
 	/////////////////////////////////
 
 	// Gets copy
-	FORCEINLINE ElementType Get(const ElementType& defaultValue) const { return IsSet() ? *_data : defaultValue; }
+	FORCEINLINE constexpr ElementType Get(const ElementType& defaultValue) const { return IsSet() ? _value : defaultValue; }
 	FORCEINLINE ElementType Get() const { return GetDefaultedImpl(); }
 
 	// Gets reference, but can crash
-	FORCEINLINE const ElementType& GetRef() const { return *_data; }
-	FORCEINLINE ElementType& GetRef() { return *_data; }
+	FORCEINLINE constexpr const ElementType& GetRef() const { return _value; }
+	FORCEINLINE constexpr ElementType& GetRef() { return _value; }
 
 	// Manipulation
 	/////////////////////////////////
@@ -80,52 +129,62 @@ public:
 	FORCEINLINE void Set(const ElementType& InValue) { Reset(); FillToEmpty(InValue); }
 	FORCEINLINE void Set(ElementType&& InValue) { Reset(); FillToEmpty(Move(InValue)); }
 
-	void Reset()
+	// Constructs value in place
+	template<typename... ArgTypes>
+	FORCEINLINE ElementType& Emplace(ArgTypes&&... args)
 	{
-		if(_data)
+		Reset();
+		SMemory::Construct(&_value, Forward<ArgTypes>(args)...);
+		_isSet = true;
+		return _value;
+	}
+
+	FORCEINLINE void Reset()
+	{
+		if(_isSet)
 		{
-			SMemory::Destruct(_data);
-			SMemory::Free(_data);
-			_data = nullptr;
+			SMemory::Destruct(&_value);
+			_isSet = false;
 		}
 	}
 
 private:
 
-	void FillToEmpty(const ElementType& InValue)
+	FORCEINLINE void FillToEmpty(const ElementType& InValue)
 	{
-		_data = SMemory::MallocTyped<ElementType>();
-		SMemory::CopyTyped(_data, &InValue);
+		SMemory::CopyTyped(&_value, &InValue);
+		_isSet = true;
 	}
 
-	void FillToEmpty(ElementType&& InValue)
+	FORCEINLINE void FillToEmpty(ElementType&& InValue)
 	{
-		_data = SMemory::MallocTyped<ElementType>();
-		SMemory::MoveTyped(_data, &InValue);
+		SMemory::MoveTyped(&_value, &InValue);
+		_isSet = true;
 	}
 
-	FORCEINLINE void FillToEmpty(const TOptional& other) 
+	FORCEINLINE void FillToEmpty(const TOptional& other)
 	{
 		if(other.IsSet())
 		{
-			FillToEmpty(*other._data);
+			FillToEmpty(other._value);
 		}
 	}
 
+	// Moved optional is left empty
 	FORCEINLINE void FillToEmpty(TOptional&& other)
 	{
 		if(other.IsSet())
 		{
-			_data = other._data;
-			other._data = nullptr;
+			FillToEmpty(Move(other._value));
+			other.Reset();
 		}
 	}
 
-	ElementType GetDefaultedImpl()
+	ElementType GetDefaultedImpl() const
 	{
 		if constexpr(TIsConstructible<ElementType>::Value)
 		{
-			return IsSet() ? *_data : ElementType();
+			return IsSet() ? _value : ElementType();
 		}
 		else
 		{
@@ -138,15 +197,17 @@ private:
 	{
 		if(Lhs.IsSet() == Rhs.IsSet())
 		{
-			return Lhs.IsSet() && SMemory::IsEqual(Lhs._data, Rhs._data) == 0;
+			return !Lhs.IsSet() || SMemory::IsEqual(&Lhs._value, &Rhs._value);
 		}
 
 		return false;
 	}
-
-	ElementType* _data = nullptr;
 };
 
+// Value is stored inline, so optional is relocatable when its value is
+template<typename T>
+struct TIsBitwiseRelocatable<TOptional<T>> { enum { Value = TIsBitwiseRelocatable<T>::Value }; };
+
 // Archive operator<< && operator>>
 ////////////////////////////////////////////
 
@@ -88,7 +88,7 @@ private:
 	AllocatorNodeType* AddImpl(const ElementT& val)
 	{
 		AllocatorNodeType* node = _allocator.Allocate(1);
-		SMemory::MoveTyped(&node->Value, &val);
+		SMemory::CopyTyped(&node->Value, &val);
 		return node;
 	}
 
@@ -151,6 +151,7 @@ private:
 		{
 			AllocatorNodeType* newNode = _allocator.Allocate(1);
 			SMemory::CopyTyped(&newNode->Value, &currentNode->Value);
+			currentNode = currentNode->Next;
 		}
 	}
 
@@ -160,9 +161,11 @@ private:
 
 		_allocator.SetHead(other._allocator.GetHead());
 		_allocator.SetTail(other._allocator.GetTail());
+		_allocator.SetSize(other._allocator.GetSize());
 
 		other._allocator.SetHead(nullptr);
 		other._allocator.SetTail(nullptr);
+		other._allocator.SetSize(0);
 	}
 
 	AllocatorType _allocator = {};
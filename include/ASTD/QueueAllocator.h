@@ -6,8 +6,17 @@
 
 #include "ASTD/Memory.h"
 
-template<typename ElementT>
-class TQueueAllocator
+// Node memory of TQueueAllocator taken from SMemory
+struct SQueueHeapMemory
+{
+	FORCEINLINE static void* Malloc(int64 size) { return SMemory::Malloc(size); }
+	FORCEINLINE static void Free(void* ptr, int64) { SMemory::Free(ptr); }
+};
+
+// Main allocator used by TQueue
+// * Every node is separate allocation from MemoryT (ex. SQueueHeapMemory, SQueueArenaMemory)
+template<typename ElementT, typename MemoryT>
+class TQueueAllocator : private MemoryT
 {
 public:
 
@@ -59,7 +68,7 @@ public:
 		NodeType* prevNode = _tail;
 		for(SizeType i = 0; i < num; ++i)
 		{
-			NodeType* newNode = SMemory::MallocTyped<NodeType>();
+			NodeType* newNode = (NodeType*)MemoryT::Malloc(sizeof(NodeType));
 			newNode->Previous = prevNode;
 			newNode->Next = nullptr;
 
@@ -102,7 +111,7 @@ public:
 			}
 		}
 
-		SMemory::Free(node);
+		MemoryT::Free(node, sizeof(NodeType));
 		--_size;
 	}
 
@@ -112,7 +121,7 @@ public:
 		while(currentNode != nullptr)
 		{
 			NodeType* nextNode = currentNode->Next;
-			SMemory::Free(currentNode);
+			MemoryT::Free(currentNode, sizeof(NodeType));
 			currentNode = nextNode;
 		}
 
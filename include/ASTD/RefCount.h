@@ -0,0 +1,203 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/_internal/SharedReferencer.h"
+
+// Base of objects that keep their reference count inside
+// * Object is deleted once the last reference is released
+// * There is no weak reference, use TSharedPtr when it is needed
+template<ESPMode Mode = ESPMode::ThreadSafe>
+class TRefCountBase
+{
+public:
+
+	static constexpr ESPMode SharedMode = Mode;
+
+	// Constructors
+	/////////////////////////////////
+
+	FORCEINLINE TRefCountBase() = default;
+
+	// Copied object starts with no references
+	FORCEINLINE TRefCountBase(const TRefCountBase&) {}
+	FORCEINLINE TRefCountBase& operator=(const TRefCountBase&) { return *this; }
+
+	virtual ~TRefCountBase()
+	{
+		// Object is deleted while still referenced
+		CHECK_RET(_refNum.Get() == 0);
+	}
+
+	// References
+	/////////////////////////////////
+
+	FORCEINLINE int32 GetRefCount() const { return _refNum.Get(); }
+
+	FORCEINLINE void AddRef() const { _refNum.Increment(); }
+
+	// Object may be deleted once this returns
+	FORCEINLINE void Release() const
+	{
+		if (_refNum.Decrement())
+		{
+			delete this;
+		}
+	}
+
+private:
+
+	mutable _NShared::TReferenceCount<Mode> _refNum = _NShared::TReferenceCount<Mode>(0);
+};
+
+// Pointer to object with intrusive reference count
+// * Works with any type that provides AddRef() and Release(), ex. TRefCountBase
+// * Can be created from raw pointer at any time (ex. from "this"), as the count lives in the object
+template<typename T>
+class TRefCountPtr
+{
+	template<typename OtherT> friend class TRefCountPtr;
+
+public:
+
+	// Typedefs
+	/////////////////////////////////
+
+	typedef T ObjectType;
+
+	// Constructors
+	/////////////////////////////////
+
+	FORCEINLINE TRefCountPtr() = default;
+	FORCEINLINE TRefCountPtr(ObjectType* object) : _object(object) { if (_object) _object->AddRef(); }
+
+	// Copy/Move constructors
+	/////////////////////////////////
+
+	FORCEINLINE TRefCountPtr(const TRefCountPtr& other) : TRefCountPtr(other._object) {}
+	FORCEINLINE TRefCountPtr(TRefCountPtr&& other) : _object(other._object) { other._object = nullptr; }
+
+	template<typename OtherT, typename TEnableIf<TIsDerivedFrom<OtherT, T>::Value>::Type* = nullptr>
+	FORCEINLINE TRefCountPtr(const TRefCountPtr<OtherT>& other) : TRefCountPtr(static_cast<ObjectType*>(other._object)) {}
+
+	template<typename OtherT, typename TEnableIf<TIsDerivedFrom<OtherT, T>::Value>::Type* = nullptr>
+	FORCEINLINE TRefCountPtr(TRefCountPtr<OtherT>&& other) : _object(other._object) { other._object = nullptr; }
+
+	// Destructor
+	/////////////////////////////////
+
+	FORCEINLINE ~TRefCountPtr() { Reset(); }
+
+	// Conversion operators
+	/////////////////////////////////
+
+	FORCEINLINE operator bool() const { return IsValid(); }
+
+	// Comparison operators
+	/////////////////////////////////
+
+	FORCEINLINE bool operator==(const TRefCountPtr& other) const { return _object == other._object; }
+	FORCEINLINE bool operator!=(const TRefCountPtr& other) const { return !operator==(other); }
+
+	// Assignment operators
+	/////////////////////////////////
+
+	FORCEINLINE TRefCountPtr& operator=(ObjectType* object) { ReplaceBy(object); return *this; }
+
+	FORCEINLINE TRefCountPtr& operator=(const TRefCountPtr& other) { ReplaceBy(other._object); return *this; }
+	FORCEINLINE TRefCountPtr& operator=(TRefCountPtr&& other)
+	{
+		if (&other != this)
+		{
+			ObjectType* previous = _object;
+			_object = other._object;
+			other._object = nullptr;
+
+			if (previous) previous->Release();
+		}
+
+		return *this;
+	}
+
+	// Pointer operators
+	/////////////////////////////////
+
+	FORCEINLINE ObjectType* operator->() const { return _object; }
+	FORCEINLINE ObjectType& operator*() const { return *_object; }
+
+	// Validation
+	/////////////////////////////////
+
+	FORCEINLINE bool IsValid() const { return _object != nullptr; }
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE ObjectType* Get() const { return _object; }
+	FORCEINLINE ObjectType& GetRef() const { return *_object; }
+
+	// Other
+	/////////////////////////////////
+
+	FORCEINLINE void Reset()
+	{
+		if (_object)
+		{
+			ObjectType* previous = _object;
+			_object = nullptr;
+
+			previous->Release();
+		}
+	}
+
+private:
+
+	// Adds reference first, so assigning pointer to the same object never releases it
+	FORCEINLINE void ReplaceBy(ObjectType* object)
+	{
+		if (object) object->AddRef();
+
+		ObjectType* previous = _object;
+		_object = object;
+
+		if (previous) previous->Release();
+	}
+
+	ObjectType* _object = nullptr;
+};
+
+template<typename T>
+struct TIsBitwiseRelocatable<TRefCountPtr<T>> { enum { Value = true }; };
+
+// Archive operator<< && operator>>
+////////////////////////////////////////////
+
+template<typename T>
+FORCEINLINE_DEBUGGABLE static SArchive& operator<<(SArchive& ar, const TRefCountPtr<T>& refCountPtr)
+{
+	if (refCountPtr.IsValid())
+	{
+		ar << refCountPtr.GetRef();
+	}
+
+	return ar;
+}
+
+template<typename T>
+FORCEINLINE_DEBUGGABLE static SArchive& operator>>(SArchive& ar, TRefCountPtr<T>& refCountPtr)
+{
+	if (refCountPtr.IsValid())
+	{
+		ar >> refCountPtr.GetRef();
+	}
+
+	return ar;
+}
+
+template<typename T, typename... ArgTypes>
+FORCEINLINE_DEBUGGABLE static TRefCountPtr<T> MakeRefCount(ArgTypes&&... args)
+{
+	return TRefCountPtr<T>(new T(Forward<ArgTypes>(args)...));
+}
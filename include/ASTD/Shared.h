@@ -8,11 +8,12 @@
 #include "ASTD/_internal/SharedTypeTraits.h"
 
 // Equivalent of std's shared_ptr
-template<typename T>
+// * ESPMode::ThreadSafe makes reference counting atomic, so copies of one pointer can be used from multiple threads
+template<typename T, ESPMode Mode>
 class TSharedPtr
 {
-	template<typename OtherT> friend class TSharedPtr;
-	template<typename OtherT> friend class TWeakPtr;
+	template<typename OtherT, ESPMode OtherMode> friend class TSharedPtr;
+	template<typename OtherT, ESPMode OtherMode> friend class TWeakPtr;
 
 public:
 
@@ -20,12 +21,15 @@ public:
 	/////////////////////////////////
 
 	typedef T ObjectType;
+	typedef _NShared::TReferencerBase<Mode> ReferencerType;
+
+	static constexpr ESPMode SharedMode = Mode;
 
 	// Constructor
 	/////////////////////////////////
 
 	FORCEINLINE TSharedPtr(_NShared::SNullType* = nullptr) {}
-	FORCEINLINE TSharedPtr(_NShared::CReferencerBase& ref) : _referencerProxy(&ref) { _referencerProxy.AddShared(); }
+	FORCEINLINE TSharedPtr(ReferencerType& ref, ObjectType* object) : _object(object), _referencerProxy(&ref) { _referencerProxy.AddShared(); }
 
 	// Copy/Move constructors [SharedPtr]
 	/////////////////////////////////
@@ -44,7 +48,7 @@ public:
 	FORCEINLINE operator bool() const { return IsValid(); }
 
 	template<typename OtherT, typename TEnableIf<TIsBaseOf<OtherT, T>::Value>::Type* = nullptr>
-	FORCEINLINE explicit operator TSharedPtr<OtherT>() const { return _referencerProxy.IsValid() ? TSharedPtr<OtherT>(*_referencerProxy) : nullptr; }
+	FORCEINLINE explicit operator TSharedPtr<OtherT, Mode>() const { return _referencerProxy.IsValid() ? TSharedPtr<OtherT, Mode>(*_referencerProxy, static_cast<OtherT*>(_object)) : nullptr; }
 
 	// Comparison operators
 	/////////////////////////////////
@@ -69,19 +73,20 @@ public:
 	// Validation
 	/////////////////////////////////
 
-	FORCEINLINE bool IsValid() const { return _referencerProxy.IsSafeToDereference(); }
+	// Shared pointer always keeps its object alive, so referencer does not have to be touched
+	FORCEINLINE bool IsValid() const { return _object != nullptr; }
 	FORCEINLINE bool IsUnique() const { return _referencerProxy.IsUnique(); }
 
 	// Getters
 	/////////////////////////////////
 
-	FORCEINLINE ObjectType* Get() const { return _referencerProxy.IsValid() ? _referencerProxy->GetObject<ObjectType>() : nullptr; }
+	FORCEINLINE ObjectType* Get() const { return _object; }
 	FORCEINLINE ObjectType& GetRef() { return *Get(); }
 
 	// Other
 	/////////////////////////////////
 
-	FORCEINLINE void Reset() { _referencerProxy.RemoveShared(); _referencerProxy.Set(nullptr); }
+	FORCEINLINE void Reset() { _referencerProxy.RemoveShared(); _referencerProxy.Set(nullptr); _object = nullptr; }
 
 private:
 
@@ -92,13 +97,14 @@ private:
 		// How it should work ? (Copy implementation)
 
 		// * SharedPtr as argument:
-		// ** 1) Remove shared reference from current
-		// ** 2) Add shared reference to other
+		// ** 1) Add shared reference to other (first, so shared object is never released in between)
+		// ** 2) Remove shared reference from current
 		// ** 3) Replace referencer
 
-		_referencerProxy.RemoveShared(); // 1
-		other._referencerProxy.AddShared(); // 2
+		other._referencerProxy.AddShared(); // 1
+		_referencerProxy.RemoveShared(); // 2
 		_referencerProxy = other._referencerProxy; // 3
+		_object = other._object;
 	}
 
 	// PtrType&&
@@ -114,18 +120,26 @@ private:
 
 		_referencerProxy.RemoveShared(); // 1
 		_referencerProxy = other._referencerProxy; // 2
+		_object = other._object;
 
 		other._referencerProxy.Set(nullptr); // 3
+		other._object = nullptr;
 	}
 
-	mutable _NShared::SReferencerProxy _referencerProxy = nullptr;
+	// Cached object, so dereferencing does not touch the referencer
+	ObjectType* _object = nullptr;
+	mutable _NShared::TReferencerProxy<Mode> _referencerProxy = nullptr;
 };
 
+// Pointers are not stored inside the referencer, so moving bytes of the pointer is enough
+template<typename T, ESPMode Mode>
+struct TIsBitwiseRelocatable<TSharedPtr<T, Mode>> { enum { Value = true }; };
+
 // Archive operator<< && operator>>
 ////////////////////////////////////////////
 
-template<typename T>
-FORCEINLINE_DEBUGGABLE static SArchive& operator<<(SArchive& ar, const TSharedPtr<T>& sharedPtr)
+template<typename T, ESPMode Mode>
+FORCEINLINE_DEBUGGABLE static SArchive& operator<<(SArchive& ar, const TSharedPtr<T, Mode>& sharedPtr)
 {
 	if (sharedPtr.IsValid())
 	{
@@ -135,8 +149,8 @@ FORCEINLINE_DEBUGGABLE static SArchive& operator<<(SArchive& ar, const TSharedPt
 	return ar;
 }
 
-template<typename T>
-FORCEINLINE_DEBUGGABLE static SArchive& operator>>(SArchive& ar, TSharedPtr<T>& sharedPtr)
+template<typename T, ESPMode Mode>
+FORCEINLINE_DEBUGGABLE static SArchive& operator>>(SArchive& ar, TSharedPtr<T, Mode>& sharedPtr)
 {
 	if (sharedPtr.IsValid())
 	{
@@ -147,11 +161,11 @@ FORCEINLINE_DEBUGGABLE static SArchive& operator>>(SArchive& ar, TSharedPtr<T>&
 }
 
 // Equivalent of std's weak_ptr
-template<typename T>
+template<typename T, ESPMode Mode>
 class TWeakPtr
 {
-	template<typename OtherT> friend class TSharedPtr;
-	template<typename OtherT> friend class TWeakPtr;
+	template<typename OtherT, ESPMode OtherMode> friend class TSharedPtr;
+	template<typename OtherT, ESPMode OtherMode> friend class TWeakPtr;
 
 public:
 
@@ -159,12 +173,13 @@ public:
 	/////////////////////////////////
 
 	typedef T ObjectType;
+	typedef _NShared::TReferencerBase<Mode> ReferencerType;
 
 	// Constructors
 	/////////////////////////////////
 
 	FORCEINLINE TWeakPtr(_NShared::SNullType* = nullptr) {}
-	FORCEINLINE TWeakPtr(_NShared::CReferencerBase& ref) : _referencerProxy(&ref) { _referencerProxy.AddWeak();}
+	FORCEINLINE TWeakPtr(ReferencerType& ref, ObjectType* object) : _object(object), _referencerProxy(&ref) { _referencerProxy.AddWeak();}
 
 	// Copy/Move constructors
 	/////////////////////////////////
@@ -172,8 +187,8 @@ public:
 	FORCEINLINE TWeakPtr(const TWeakPtr& other) { ReplaceBy(other); }
 	FORCEINLINE TWeakPtr(TWeakPtr&& other) noexcept { ReplaceBy(Forward<TWeakPtr>(other)); }
 
-	FORCEINLINE explicit TWeakPtr(const TSharedPtr<T>& other) { ReplaceBy(other); }
-	FORCEINLINE explicit TWeakPtr(TSharedPtr<T>&& other) noexcept { ReplaceBy(Forward<TSharedPtr<T>>(other)); }
+	FORCEINLINE explicit TWeakPtr(const TSharedPtr<T, Mode>& other) { ReplaceBy(other); }
+	FORCEINLINE explicit TWeakPtr(TSharedPtr<T, Mode>&& other) noexcept { ReplaceBy(Forward<TSharedPtr<T, Mode>>(other)); }
 
 	// Destructor
 	/////////////////////////////////
@@ -186,10 +201,10 @@ public:
 	FORCEINLINE operator bool() const { return IsValid(); }
 
 	template<typename OtherT, typename TEnableIf<TIsDerivedFrom<OtherT, T>::Value>::Type* = nullptr>
-	FORCEINLINE operator TWeakPtr<OtherT>() const { return _referencerProxy.IsValid() ? TWeakPtr<OtherT>(*_referencerProxy) : nullptr; }
+	FORCEINLINE operator TWeakPtr<OtherT, Mode>() const { return _referencerProxy.IsValid() ? TWeakPtr<OtherT, Mode>(*_referencerProxy, static_cast<OtherT*>(_object)) : nullptr; }
 
 	template<typename OtherT, typename TEnableIf<TIsBaseOf<OtherT, T>::Value>::Type* = nullptr>
-	FORCEINLINE explicit operator TWeakPtr<OtherT>() const { return _referencerProxy.IsValid() ? TWeakPtr<OtherT>(*_referencerProxy) : nullptr; }
+	FORCEINLINE explicit operator TWeakPtr<OtherT, Mode>() const { return _referencerProxy.IsValid() ? TWeakPtr<OtherT, Mode>(*_referencerProxy, static_cast<OtherT*>(_object)) : nullptr; }
 
 	// Comparison operators [WeakPtr]
 	/////////////////////////////////
@@ -200,8 +215,8 @@ public:
 	// Comparison operators [SharedPtr]
 	/////////////////////////////////
 
-	FORCEINLINE bool operator==(const TSharedPtr<T>& other) const	{ return _referencerProxy == other._referencerProxy; }
-	FORCEINLINE bool operator!=(const TSharedPtr<T>& other) const	{ return !operator==(other); }
+	FORCEINLINE bool operator==(const TSharedPtr<T, Mode>& other) const	{ return _referencerProxy == other._referencerProxy; }
+	FORCEINLINE bool operator!=(const TSharedPtr<T, Mode>& other) const	{ return !operator==(other); }
 
 	// Assignment operators
 	/////////////////////////////////
@@ -217,8 +232,8 @@ public:
 	// Assignment operators [SharedPtr]
 	/////////////////////////////////
 
-	FORCEINLINE TWeakPtr& operator=(const TSharedPtr<T>& other) { ReplaceBy(other); return *this; }
-	FORCEINLINE TWeakPtr& operator=(TSharedPtr<T>&& other) { ReplaceBy(Forward<TSharedPtr<T>>(other)); return *this; }
+	FORCEINLINE TWeakPtr& operator=(const TSharedPtr<T, Mode>& other) { ReplaceBy(other); return *this; }
+	FORCEINLINE TWeakPtr& operator=(TSharedPtr<T, Mode>&& other) { ReplaceBy(Forward<TSharedPtr<T, Mode>>(other)); return *this; }
 
 	// Pointer operators
 	/////////////////////////////////
@@ -230,20 +245,32 @@ public:
 	// Validity
 	/////////////////////////////////
 
+	// With ESPMode::ThreadSafe object can be released right after the check, use Pin to keep it alive
 	FORCEINLINE bool IsValid() const { return _referencerProxy.IsSafeToDereference(); }
 
 	// Getters
 	/////////////////////////////////
 
-	FORCEINLINE ObjectType* Get() const { return _referencerProxy.IsValid() ? _referencerProxy->GetObject<ObjectType>() : nullptr; }
+	FORCEINLINE ObjectType* Get() const { return IsValid() ? _object : nullptr; }
 	FORCEINLINE ObjectType& GetRef() const { return *Get(); }
 
 	// Other
 	/////////////////////////////////
 
-	FORCEINLINE void Reset() { _referencerProxy.RemoveWeak(); _referencerProxy.Set(nullptr); }
+	FORCEINLINE void Reset() { _referencerProxy.RemoveWeak(); _referencerProxy.Set(nullptr); _object = nullptr; }
+
+	// Gets shared pointer keeping object alive, invalid when object is already released
+	FORCEINLINE TSharedPtr<T, Mode> Pin() const
+	{
+		TSharedPtr<T, Mode> shared;
+		if (_referencerProxy.TryAddShared())
+		{
+			shared._referencerProxy = _referencerProxy;
+			shared._object = _object;
+		}
 
-	FORCEINLINE TSharedPtr<T> Pin() const { return IsValid() ? TSharedPtr<T>(_referencerProxy) : TSharedPtr<T>(); }
+		return shared;
+	}
 
 private:
 
@@ -255,18 +282,19 @@ private:
 		// How it should work ? (Copy implementation)
 
 		// * WeakPtr as argument:
-		// ** 1) Remove weak reference from current
-		// ** 2) Add weak reference to other
+		// ** 1) Add weak reference to other
+		// ** 2) Remove weak reference from current
 		// ** 3) Replace referencer
 
 		// * SharedPtr as argument:
-		// ** 1) Remove weak reference from current
-		// ** 2) Add weak reference to other
+		// ** 1) Add weak reference to other
+		// ** 2) Remove weak reference from current
 		// ** 3) Replace referencer
 
-		_referencerProxy.RemoveWeak(); // 1
-		other._referencerProxy.AddWeak(); // 2
+		other._referencerProxy.AddWeak(); // 1
+		_referencerProxy.RemoveWeak(); // 2
 		_referencerProxy = other._referencerProxy; // 3
+		_object = other._object;
 	}
 
 	// PtrType&&
@@ -289,48 +317,58 @@ private:
 		// ** 2) Replace referencer
 		// ** 3) Clear other referencer
 
+		typename TWeakPtr::ReferencerType* referencer = other._referencerProxy.Get();
+		ObjectType* object = other._object;
+
 		// * Only SharedPtr
-		if(TIsSame<typename TRemoveReference<PtrType>::Type, TSharedPtr<T>>::Value)
+		if constexpr (TIsSame<typename TRemoveReference<PtrType>::Type, TSharedPtr<T, Mode>>::Value)
 		{
 			other._referencerProxy.AddWeak(); // -2
 			other._referencerProxy.RemoveShared(); // -1
 		}
 
 		_referencerProxy.RemoveWeak(); // 1
-		_referencerProxy = other._referencerProxy; // 2
+		_referencerProxy.Set(referencer); // 2
+		_object = object;
 
 		other._referencerProxy.Set(nullptr); // 3
+		other._object = nullptr;
 	}
 
-	mutable _NShared::SReferencerProxy _referencerProxy = nullptr;
+	// Cached object, valid only while referencer has shared references
+	ObjectType* _object = nullptr;
+	mutable _NShared::TReferencerProxy<Mode> _referencerProxy = nullptr;
 };
 
+template<typename T, ESPMode Mode>
+struct TIsBitwiseRelocatable<TWeakPtr<T, Mode>> { enum { Value = true }; };
+
 // Archive operator<< && operator>>
 ////////////////////////////////////////////
 
-template<typename T>
-FORCEINLINE_DEBUGGABLE static SArchive& operator<<(SArchive& ar, const TWeakPtr<T>& weakPtr)
+template<typename T, ESPMode Mode>
+FORCEINLINE_DEBUGGABLE static SArchive& operator<<(SArchive& ar, const TWeakPtr<T, Mode>& weakPtr)
 {
-	if (weakPtr.IsValid())
+	if (TSharedPtr<T, Mode> sharedPtr = weakPtr.Pin())
 	{
-		ar << weakPtr.Pin().GetRef();
+		ar << sharedPtr.GetRef();
 	}
 
 	return ar;
 }
 
-template<typename T>
-FORCEINLINE_DEBUGGABLE static SArchive& operator>>(SArchive& ar, TWeakPtr<T>& weakPtr)
+template<typename T, ESPMode Mode>
+FORCEINLINE_DEBUGGABLE static SArchive& operator>>(SArchive& ar, TWeakPtr<T, Mode>& weakPtr)
 {
-	if (weakPtr.IsValid())
+	if (TSharedPtr<T, Mode> sharedPtr = weakPtr.Pin())
 	{
-		ar >> weakPtr.Pin().GetRef();
+		ar >> sharedPtr.GetRef();
 	}
 
 	return ar;
 }
 
-template<typename T>
+template<typename T, ESPMode Mode>
 class TSharedClass
 {
 public:
@@ -339,6 +377,8 @@ public:
 
 	typedef T ClassType;
 
+	static constexpr ESPMode SharedMode = Mode;
+
 	// Constructors
 	/////////////////////////////////
 
@@ -353,23 +393,22 @@ public:
 	/////////////////////////////////
 
 	// Gets pointer as shared_ptr
-	FORCEINLINE TSharedPtr<ClassType> AsShared()
+	FORCEINLINE TSharedPtr<ClassType, Mode> AsShared()
 	{
-		CHECK_RET(_weakThis.IsValid(), nullptr);
+		CHECK_RET(_isSharedInitialized, nullptr);
 		return _weakThis.Pin();
 	}
 
 	// Gets pointer as shared_ptr with provided type
 	template<typename ChildType>
-	FORCEINLINE TSharedPtr<ChildType> AsShared()
+	FORCEINLINE TSharedPtr<ChildType, Mode> AsShared()
 	{
-		CHECK_RET(_weakThis.IsValid(), nullptr);
-		return _weakThis.Pin();
+		CHECK_RET(_isSharedInitialized, nullptr);
+		return TSharedPtr<ChildType, Mode>(_weakThis.Pin());
 	}
 
-private:
 	// Do not call this method DIRECTLY!
-	FORCEINLINE void Init_Private(const TSharedPtr<ClassType>& ptr)
+	FORCEINLINE void Init_Private(const TSharedPtr<ClassType, Mode>& ptr)
 	{
 		CHECK_RET(!_isSharedInitialized);
 
@@ -377,34 +416,57 @@ private:
 		_isSharedInitialized = true;
 	}
 
-	mutable TWeakPtr<ClassType> _weakThis;
+private:
+
+	mutable TWeakPtr<ClassType, Mode> _weakThis;
 	bool _isSharedInitialized;
 };
 
-template<typename T, typename InstanceT = T>
-FORCEINLINE_DEBUGGABLE static TSharedPtr<T> MakeShareable(InstanceT* instance)
+// Do not call this method DIRECTLY!
+template<typename T, ESPMode Mode>
+FORCEINLINE_DEBUGGABLE static TSharedPtr<T, Mode> MakeSharedFromReferencer_Private(_NShared::TReferencerBase<Mode>* referencer, T* object)
 {
-	static_assert(TIsDerivedFrom<InstanceT,T>::Value, "Instance type must be derived from return type");
+	CHECK_RET(referencer, nullptr);
 
-	_NShared::CReferencerBase* referencer = _NShared::NewCustomReferencer(instance);
-	TSharedPtr<T> newShared = TSharedPtr<T>(*referencer);
+	TSharedPtr<T, Mode> newShared = TSharedPtr<T, Mode>(*referencer, object);
 	if constexpr (_NShared::TIsSharedClassType<T>::Value)
 	{
-		newShared->Init_Private(TSharedPtr<typename T::ClassType>(referencer));
+		static_assert(T::SharedMode == Mode, "Shared class has to be used with the same mode");
+		newShared->Init_Private(TSharedPtr<typename T::ClassType, Mode>(*referencer, static_cast<typename T::ClassType*>(object)));
 	}
 
 	return newShared;
 }
 
-template<typename T, typename... ArgTypes>
-FORCEINLINE_DEBUGGABLE static TSharedPtr<T> MakeShared(ArgTypes&&... args)
+// Takes ownership of already allocated instance, referencer is allocated separately
+template<typename T, ESPMode Mode = ESPMode::ThreadSafe, typename InstanceT = T>
+FORCEINLINE_DEBUGGABLE static TSharedPtr<T, Mode> MakeShareable(InstanceT* instance)
+{
+	static_assert(TIsDerivedFrom<InstanceT,T>::Value, "Instance type must be derived from return type");
+	return MakeSharedFromReferencer_Private<T, Mode>(_NShared::NewCustomReferencer<InstanceT, Mode>(instance), instance);
+}
+
+// Constructs object together with its referencer in memory from the allocator
+// * Allocator: void* Allocate(int64 size), void Free(void* ptr, int64 size)
+// * Allocator is copied into the referencer, pools should be passed as lightweight handles
+template<typename T, ESPMode Mode = ESPMode::ThreadSafe, typename AllocatorT, typename... ArgTypes>
+FORCEINLINE_DEBUGGABLE static TSharedPtr<T, Mode> MakeSharedWithAllocator(const AllocatorT& allocator, ArgTypes&&... args)
+{
+	auto* referencer = _NShared::NewInlineReferencer<T, Mode>(allocator, Forward<ArgTypes>(args)...);
+	return MakeSharedFromReferencer_Private<T, Mode>(referencer, referencer ? referencer->GetObject() : nullptr);
+}
+
+// Constructs object together with its referencer, using single allocation
+// * Over-aligned objects use aligned allocation
+template<typename T, ESPMode Mode = ESPMode::ThreadSafe, typename... ArgTypes>
+FORCEINLINE_DEBUGGABLE static TSharedPtr<T, Mode> MakeShared(ArgTypes&&... args)
 {
-	if constexpr (sizeof...(args) > 0)
+	if constexpr (alignof(T) > alignof(std::max_align_t))
 	{
-		return MakeShareable<T>(new T(Forward<ArgTypes>(args)...));
+		return MakeSharedWithAllocator<T, Mode>(_NShared::TAlignedReferencerAllocator<alignof(T)>(), Forward<ArgTypes>(args)...);
 	}
 	else
 	{
-		return MakeShareable<T>(new T());
+		return MakeSharedWithAllocator<T, Mode>(_NShared::SReferencerAllocator(), Forward<ArgTypes>(args)...);
 	}
 }
@@ -0,0 +1,111 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/Math.h"
+#include "ASTD/Memory.h"
+
+// Archive over memory block owned by caller (stack, arena, mapped region, network buffer...)
+// * Never allocates, writes past the capacity are cut and mark the archive as overflowed
+// * Memory has to outlive the archive
+struct SSpanArchive : public SArchive
+{
+	// Writable span, "size" is number of already valid bytes
+	FORCEINLINE SSpanArchive(EArchiveType type, EArchiveMode mode, void* data, SizeType capacity, SizeType size = 0)
+		: SArchive(type, mode)
+	{
+		SetSpan(data, capacity, size);
+	}
+
+	// Read-only span
+	FORCEINLINE SSpanArchive(EArchiveType type, const void* data, SizeType size)
+		: SArchive(type, EArchiveMode::Read)
+	{
+		// Mode prevents writes into const memory
+		SetSpan(const_cast<void*>(data), size, size);
+	}
+
+	// Span set/get
+	/////////////////////////////////
+
+	// Replaces memory block and moves to its beginning
+	FORCEINLINE void SetSpan(void* data, SizeType capacity, SizeType size = 0)
+	{
+		_data = (uint8*)data;
+		_capacity = data ? SMath::Max<SizeType>(capacity, 0) : 0;
+		_size = SMath::Clamp<SizeType>(size, 0, _capacity);
+		_offset = 0;
+		_hasOverflow = false;
+	}
+
+	FORCEINLINE const uint8* GetData() const { return _data; }
+	FORCEINLINE SizeType GetCapacity() const { return _capacity; }
+	FORCEINLINE SizeType GetRemainingCapacity() const { return _capacity - _offset; }
+
+	// Whether some write did not fit into the span
+	FORCEINLINE bool HasOverflow() const { return _hasOverflow; }
+
+	// SArchive overrides
+	/////////////////////////////////
+
+	FORCEINLINE virtual bool IsValid() const override { return !!_data; }
+	FORCEINLINE virtual void Flush() override {}
+	FORCEINLINE virtual SizeType GetTotalBytes() const override { return _size; }
+	FORCEINLINE virtual SizeType GetBytesOffset() const override { return _offset; }
+
+	FORCEINLINE virtual bool SetBytesOffset(SizeType offset) override
+	{
+		if (offset < 0 || offset > _size) return false;
+
+		_offset = offset;
+		return true;
+	}
+
+	virtual SizeType ReadBytes(void* ptr, SizeType size) override
+	{
+		if (!ptr || size <= 0) return 0;
+		else if (!AllowsRead()) return 0;
+
+		const SizeType readBytes = SMath::Min(size, _size - _offset);
+		if (readBytes > 0)
+		{
+			SMemory::Copy(ptr, _data + _offset, readBytes);
+			_offset += readBytes;
+		}
+
+		return readBytes > 0 ? readBytes : 0;
+	}
+
+	virtual SizeType WriteBytes(const void* ptr, SizeType size) override
+	{
+		if (!ptr || size <= 0) return 0;
+		else if (!AllowsWrite()) return 0;
+
+		const SizeType writtenBytes = SMath::Min(size, _capacity - _offset);
+		if (writtenBytes < size)
+		{
+			_hasOverflow = true;
+		}
+
+		if (writtenBytes > 0)
+		{
+			SMemory::Copy(_data + _offset, ptr, writtenBytes);
+
+			_offset += writtenBytes;
+			_size = SMath::Max(_size, _offset);
+		}
+
+		return writtenBytes > 0 ? writtenBytes : 0;
+	}
+
+private:
+
+	uint8* _data = nullptr;
+	SizeType _capacity = 0;
+	SizeType _size = 0;
+	SizeType _offset = 0;
+	bool _hasOverflow = false;
+};
@@ -43,7 +43,7 @@ struct TStdoutArchive : public TArrayArchive<tchar, AllocatorT>
 			const auto& data = Super::GetData();
 			if (!data.IsEmpty())
 			{
-				SMisc::WriteToFile(FileNo, data.GetData(), data.GetNum());
+				SMisc::WriteStd(FileNo, data.GetData(), data.GetNum() * Super::ELEMENT_SIZE);
 			}
 		}
 
@@ -60,27 +60,30 @@ struct TStdoutArchive : public TArrayArchive<tchar, AllocatorT>
 		if (!ptr || size < Super::ELEMENT_SIZE) return 0;
 		else if (!Super::AllowsWrite()) return 0;
 
-		const tchar* buffer = (tchar*)ptr;
-		SizeType lenght = size;
+		const tchar* buffer = (const tchar*)ptr;
+		const SizeType length = size / Super::ELEMENT_SIZE;
 
-		SizeType totalWrittenBytes = 0;
-		for (SizeType i = 0; i < lenght; ++i)
+		// Everything till the last new line is flushed with single write
+		SizeType flushLength = 0;
+		for (SizeType i = length; i > 0; --i)
 		{
-			if (buffer[i] == CHAR_NEWLINE)
+			if (buffer[i - 1] == CHAR_NEWLINE)
 			{
-				totalWrittenBytes += Super::WriteBytes(buffer, i + 1);
-
-				buffer += i + 1;
-				lenght -= i + 1;
-				i = 0;
-
-				Flush();
+				flushLength = i;
+				break;
 			}
 		}
 
-		if (lenght > 0)
+		SizeType totalWrittenBytes = 0;
+		if (flushLength > 0)
+		{
+			totalWrittenBytes += Super::WriteBytes(buffer, flushLength * Super::ELEMENT_SIZE);
+			Flush();
+		}
+
+		if (length > flushLength)
 		{
-			totalWrittenBytes += Super::WriteBytes(buffer, lenght);
+			totalWrittenBytes += Super::WriteBytes(buffer + flushLength, (length - flushLength) * Super::ELEMENT_SIZE);
 		}
 
 		return totalWrittenBytes;
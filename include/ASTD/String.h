@@ -9,13 +9,15 @@
 #include "ASTD/Array.h"
 #include "ASTD/CString.h"
 
-struct SString
+// Null terminated string, memory comes from AllocatorT (see SString and SArenaString)
+template<typename AllocatorT>
+struct TString
 {
 	// Types
 	/////////////////////////////////
 
 	typedef tchar CharType;
-	typedef TArray<CharType> DataType;
+	typedef TArray<CharType, AllocatorT> DataType;
 	typedef typename DataType::SizeType SizeType;
 
 	typedef CharType* StringIteratorType;
@@ -24,47 +26,47 @@ struct SString
 	// Constructors
 	/////////////////////////////////
 
-	FORCEINLINE SString() { InitToEmpty(); }
+	FORCEINLINE TString() { InitToEmpty(); }
 
-	FORCEINLINE SString(const SString& other) { AppendStringImpl(other); }
-	FORCEINLINE SString(SString&& other) noexcept { AppendStringImpl(Move(other)); }
+	FORCEINLINE TString(const TString& other) { AppendStringImpl(other); }
+	FORCEINLINE TString(TString&& other) noexcept { AppendStringImpl(Move(other)); }
 
-	FORCEINLINE SString(const CharType* text) { AppendCharsImpl(text); }
-	FORCEINLINE SString(const CharType* text, SizeType length) { AppendCharsImpl(text, length); }
+	FORCEINLINE TString(const CharType* text) { AppendCharsImpl(text); }
+	FORCEINLINE TString(const CharType* text, SizeType length) { AppendCharsImpl(text, length); }
 
 	// fill constructor
-	FORCEINLINE SString(SizeType length, CharType val = CHAR_TERM) { InitToFill(length, val); }
+	FORCEINLINE TString(SizeType length, CharType val = CHAR_TERM) { InitToFill(length, val); }
 
-	FORCEINLINE explicit SString(const DataType& data) { AppendDataImpl(data); }
-	FORCEINLINE explicit SString(DataType&& data) noexcept { AppendDataImpl(Move(data)); }
+	FORCEINLINE explicit TString(const DataType& data) { AppendDataImpl(data); }
+	FORCEINLINE explicit TString(DataType&& data) noexcept { AppendDataImpl(Move(data)); }
 
 	// Gets the empty string as a non-mutable reference
-	static const SString& GetEmpty()
+	static const TString& GetEmpty()
 	{
-		static SString emptyString = SString();
+		static TString emptyString = TString();
 		return emptyString;
 	}
 
 	// Compare operators
 	/////////////////////////////////
 
-	FORCEINLINE bool operator==(const SString& other) const { return _data == other._data; }
-	FORCEINLINE bool operator!=(const SString& other) const { return !operator==(other); }
+	FORCEINLINE bool operator==(const TString& other) const { return _data == other._data; }
+	FORCEINLINE bool operator!=(const TString& other) const { return !operator==(other); }
 
 	// Assign operators
 	/////////////////////////////////
 
-	FORCEINLINE SString& operator=(const SString& other) { InitToEmpty(); AppendStringImpl(other); return *this; }
-	FORCEINLINE SString& operator=(SString&& other) noexcept { InitToEmpty(); AppendStringImpl(Move(other)); return *this; }
+	FORCEINLINE TString& operator=(const TString& other) { InitToEmpty(); AppendStringImpl(other); return *this; }
+	FORCEINLINE TString& operator=(TString&& other) noexcept { InitToEmpty(); AppendStringImpl(Move(other)); return *this; }
 
 	// Arithmetic operators
 	/////////////////////////////////
 
-	FORCEINLINE SString operator+(const SString& other) const { SString tmpStr(*this); tmpStr.AppendStringImpl(other); return *this; }
-	FORCEINLINE SString operator+(SString&& other) const { SString tmpStr(*this); tmpStr.AppendStringImpl(Move(other)); return *this; }
+	FORCEINLINE TString operator+(const TString& other) const { TString tmpStr(*this); tmpStr.AppendStringImpl(other); return *this; }
+	FORCEINLINE TString operator+(TString&& other) const { TString tmpStr(*this); tmpStr.AppendStringImpl(Move(other)); return *this; }
 
-	FORCEINLINE SString& operator+=(const SString& other) { AppendStringImpl(other); return *this; }
-	FORCEINLINE SString& operator+=(SString&& other) { AppendStringImpl(Move(other)); return *this; }
+	FORCEINLINE TString& operator+=(const TString& other) { AppendStringImpl(other); return *this; }
+	FORCEINLINE TString& operator+=(TString&& other) { AppendStringImpl(Move(other)); return *this; }
 
 	// Get operators
 	/////////////////////////////////
@@ -77,8 +79,8 @@ struct SString
 	// Path operators
 	/////////////////////////////////
 
-	FORCEINLINE SString operator/(const SString& other) const { SString tmpStr(*this); tmpStr.operator/=(other); return tmpStr; }
-	FORCEINLINE SString operator/=(const SString& other) { AppendCharsImpl(TEXT("/")); AppendStringImpl(other); return *this; }
+	FORCEINLINE TString operator/(const TString& other) const { TString tmpStr(*this); tmpStr.operator/=(other); return tmpStr; }
+	FORCEINLINE TString operator/=(const TString& other) { AppendCharsImpl(TEXT("/")); AppendStringImpl(other); return *this; }
 
 	// Property getters
 	/////////////////////////////////
@@ -103,10 +105,10 @@ struct SString
 	template<
 		typename StringT,
 		typename... VarTypes>
-	static SString Printf(StringT&& fmt, VarTypes&&... args)
+	static TString Printf(StringT&& fmt, VarTypes&&... args)
 	{
 		static_assert(sizeof...(VarTypes) > 0, "No arguments provided. Use construction from fmt directly instead");
-		static_assert(TIsSame<typename TPure<StringT>::Type, CharType*>::Value || TIsSame<typename TPure<StringT>::Type, SString>::Value, "Format variable has to be string type");
+		static_assert(TIsSame<typename TPure<StringT>::Type, CharType*>::Value || TIsSame<typename TPure<StringT>::Type, TString>::Value, "Format variable has to be string type");
 		thread_local CharType buffer[SCString::LARGE_BUFFER_SIZE];
 
 		// TODO: Replace with custom implementation
@@ -119,7 +121,7 @@ struct SString
 			snprintf(buffer, SCString::LARGE_BUFFER_SIZE, fmt, Forward<VarTypes>(args)...);
 		}
 
-		return SString(buffer);
+		return TString(buffer);
 	}
 
 	// Conversions
@@ -139,26 +141,26 @@ struct SString
 
 	// Constructs new string from int32
 	// * 10 => "10"
-	static SString FromInt32(int32 val)
+	static TString FromInt32(int32 val)
 	{
 		thread_local CharType buffer[SCString::MAX_BUFFER_SIZE_INT32];
-		return SString(SCString::FromInt32(val, buffer, SCString::MAX_BUFFER_SIZE_INT32));
+		return TString(SCString::FromInt32(val, buffer, SCString::MAX_BUFFER_SIZE_INT32));
 	}
 
 	// Constructs new string from int64
 	// * 10 => "10"
-	static SString FromInt64(int64 val)
+	static TString FromInt64(int64 val)
 	{
 		thread_local CharType buffer[SCString::MAX_BUFFER_SIZE_INT64];
-		return SString(SCString::FromInt64(val, buffer, SCString::MAX_BUFFER_SIZE_INT64));
+		return TString(SCString::FromInt64(val, buffer, SCString::MAX_BUFFER_SIZE_INT64));
 	}
 
 	// Constructs new string from double, providing number of digits to expect
 	// * 10.1 => "10.1"
-	static SString FromDouble(double val, uint8 digits)
+	static TString FromDouble(double val, uint8 digits)
 	{
 		thread_local CharType buffer[SCString::MAX_BUFFER_SIZE_DOUBLE];
-		return SString(SCString::FromDouble(val, digits, buffer, SCString::MAX_BUFFER_SIZE_DOUBLE));
+		return TString(SCString::FromDouble(val, digits, buffer, SCString::MAX_BUFFER_SIZE_DOUBLE));
 	}
 
 	// Iterations
@@ -175,11 +177,11 @@ struct SString
 
 	// Compares this string against the provided one
 	// * returns 0 if equal, -1 if this string is "bigger" and 1 if provided string is "bigger"
-	FORCEINLINE int32 Compare(const SString& other, bool caseSensitive = true) const { return SCString::Compare(GetChars(), other.GetChars(), caseSensitive); }
+	FORCEINLINE int32 Compare(const TString& other, bool caseSensitive = true) const { return SCString::Compare(GetChars(), other.GetChars(), caseSensitive); }
 
 	// Checks whether this string is same as the provided one
 	// * Is same as Compare == 0
-	FORCEINLINE bool Equals(const SString& other, bool caseSensitive = true) const { return Compare(other, caseSensitive) == 0; }
+	FORCEINLINE bool Equals(const TString& other, bool caseSensitive = true) const { return Compare(other, caseSensitive) == 0; }
 
 	// Checks
 	/////////////////////////////////
@@ -203,31 +205,31 @@ struct SString
 	}
 
 	// Checks whether this string contains provided string from the beginning
-	FORCEINLINE bool StartsWith(const SString& val, bool caseSensitive = true) const
+	FORCEINLINE bool StartsWith(const TString& val, bool caseSensitive = true) const
 	{
 		return ContainsAtIndexImpl(*this, val, 0, caseSensitive);
 	}
 
 	// Checks whether this string contains provided string from the end
-	FORCEINLINE bool EndsWith(const SString& val, bool caseSensitive = true) const
+	FORCEINLINE bool EndsWith(const TString& val, bool caseSensitive = true) const
 	{
 		return ContainsAtIndexImpl(*this, val, GetLastCharIndex() - val.GetLastCharIndex(), caseSensitive);
 	}
 
 	// Checks whether this string contains provided string in any place
-	FORCEINLINE bool Contains(const SString& val, bool caseSensitive = true, bool fromStart = true) const
+	FORCEINLINE bool Contains(const TString& val, bool caseSensitive = true, bool fromStart = true) const
 	{
 		return !!SCString::Find(GetChars(), val.GetChars(), caseSensitive, fromStart);
 	}
 
 	// Checks whether this string contains provided string in provided index
-	FORCEINLINE bool ContainsAt(const SString& val, SizeType index, bool caseSensitive = true)
+	FORCEINLINE bool ContainsAt(const TString& val, SizeType index, bool caseSensitive = true)
 	{
 		return ContainsAtIndexImpl(*this, val, index, caseSensitive);
 	}
 
 	// Gets index from which this string contains provided string
-	FORCEINLINE SizeType Find(const SString& val, bool caseSensitive = true, bool fromStart = true) const
+	FORCEINLINE SizeType Find(const TString& val, bool caseSensitive = true, bool fromStart = true) const
 	{
 		return SCString::FindIndex(GetChars(), val.GetChars(), caseSensitive, fromStart);
 	}
@@ -236,8 +238,8 @@ struct SString
 	/////////////////////////////////
 
 	// Appends this string with other string
-	FORCEINLINE void Append(const SString& other) { AppendStringImpl(other); }
-	FORCEINLINE void Append(SString&& other) { AppendStringImpl(Move(other)); }
+	FORCEINLINE void Append(const TString& other) { AppendStringImpl(other); }
+	FORCEINLINE void Append(TString&& other) { AppendStringImpl(Move(other)); }
 	FORCEINLINE void Append(const CharType* other, SizeType num = INDEX_NONE) { AppendCharsImpl(other, num); }
 
 	// Appends this string via "printf"
@@ -246,7 +248,7 @@ struct SString
 	{
 		AppendStringImpl(
 			Move(
-				SString::Printf(
+				TString::Printf(
 					Forward<StringT>(fmt),
 					Forward<ArgTypes>(args)...
 				)
@@ -257,7 +259,7 @@ struct SString
 	// Const manipulation
 	/////////////////////////////////
 
-	bool Split(const SString& val, SString* outLeft, SString* outRight, bool caseSensitive = true, bool fromStart = true) const
+	bool Split(const TString& val, TString* outLeft, TString* outRight, bool caseSensitive = true, bool fromStart = true) const
 	{
 		const SizeType foundIdx = SCString::FindIndex(GetChars(), val.GetChars(), caseSensitive, fromStart);
 		if (foundIdx == INDEX_NONE)
@@ -277,16 +279,17 @@ struct SString
 		return true;
 	}
 
-	TArray<SString> SplitToArray(const SString& delimiter, bool discardEmpty = true, SizeType num = INDEX_NONE, bool caseSensitive = true) const
+	TArray<TString> SplitToArray(const TString& delimiter, bool discardEmpty = true, SizeType num = INDEX_NONE, bool caseSensitive = true) const
 	{
-		TArray<SString> result;
+		TArray<TString> result;
 
 		SplitBySubstringPrivate(*this, delimiter, discardEmpty, caseSensitive, _data.GetNum(),
 			[&result, &num](const CharType* ptr, SizeType count) -> bool
 			{
-				SString& newStr = result.AddUninitialized_GetRef();
-				newStr._data = DataType(ptr, count);
-				newStr._data.Add(CHAR_TERM);
+				// Zero length would be read as unknown length by the constructor
+				if (count > 0) result.Emplace(ptr, count);
+				else result.AddDefaulted();
+
 				return (--num == 0);
 			}
 		);
@@ -297,15 +300,15 @@ struct SString
 	// Manipulation
 	/////////////////////////////////
 
-	SString Replace(const SString& from, const SString& to, SizeType num = INDEX_NONE, bool caseSensitive = true) const
+	TString Replace(const TString& from, const TString& to, SizeType num = INDEX_NONE, bool caseSensitive = true) const
 	{
-		SString newString(*this);
+		TString newString(*this);
 		newString.ReplaceInline(from, to, num, caseSensitive);
 		return newString;
 	}
 
 	// -1 = All
-	void ReplaceInline(const SString& from, const SString& to, SizeType num = INDEX_NONE, bool caseSensitive = true)
+	void ReplaceInline(const TString& from, const TString& to, SizeType num = INDEX_NONE, bool caseSensitive = true)
 	{
 		DataType newData(_data.GetNum(), true);
 		SplitBySubstringPrivate(*this, from, false, caseSensitive, (num == -1) ? _data.GetNum() : num,
@@ -344,18 +347,18 @@ struct SString
 		}
 	}
 
-	SString ToUpper() const
+	TString ToUpper() const
 	{
-		SString newString(*this);
+		TString newString(*this);
 		newString.ToUpperInline();
 		return newString;
 	}
 
 	FORCEINLINE void ToUpperInline() { SCString::ToUpper(_data.GetData()); }
 
-	SString ToLower() const
+	TString ToLower() const
 	{
-		SString newString(*this);
+		TString newString(*this);
 		newString.ToLowerInline();
 		return newString;
 	}
@@ -365,9 +368,9 @@ struct SString
 	// Removes all characters from the index position to the end of the string
 	// * Does NOT modify the source string
 	// * ChopRight at index 1 for "ABC" returns "A"
-	SString ChopRight(SizeType idx) const
+	TString ChopRight(SizeType idx) const
 	{
-		SString newString(*this);
+		TString newString(*this);
 		newString.ChopRightInline(idx);
 		return newString;
 	}
@@ -389,9 +392,9 @@ struct SString
 	// Removes all characters from the start of the string to the index position
 	// * Does NOT modify the source string
 	// * ChopLeft at index 1 for "ABC" returns "C"
-	SString ChopLeft(SizeType idx) const
+	TString ChopLeft(SizeType idx) const
 	{
-		SString newString(*this);
+		TString newString(*this);
 		newString.ChopLeftInline(idx);
 		return newString;
 	}
@@ -415,9 +418,9 @@ struct SString
 		_data = Move(newData);
 	}
 
-	SString ChopRange(SizeType firstIdx, SizeType secondIdx) const
+	TString ChopRange(SizeType firstIdx, SizeType secondIdx) const
 	{
-		SString newString(*this);
+		TString newString(*this);
 		newString.ChopRangeInline(firstIdx, secondIdx);
 		return newString;
 	}
@@ -483,7 +486,7 @@ private:
 
 	template<
 		typename StringT,
-		typename TEnableIf<TIsSame<typename TDecay<StringT>::Type, SString>::Value>::Type* = nullptr>
+		typename TEnableIf<TIsSame<typename TDecay<StringT>::Type, TString>::Value>::Type* = nullptr>
 	void AppendStringImpl(StringT&& str)
 	{
 		RemoveTerm(_data);
@@ -510,7 +513,7 @@ private:
 	FORCEINLINE static void RemoveTermChecked(DataType& data) { data.RemoveAt(data.GetNum() - 1); }
 	FORCEINLINE static void RemoveTerm(DataType& data) { if (HasTerm(data)) { RemoveTermChecked(data); }}
 
-	static bool ContainsAtIndexImpl(const SString& str, const SString& val, SizeType idx, bool caseSensitive)
+	static bool ContainsAtIndexImpl(const TString& str, const TString& val, SizeType idx, bool caseSensitive)
 	{
 		if(idx < 0 || str.GetLength() < idx + val.GetLength())
 			return false;
@@ -537,7 +540,7 @@ private:
 
 	template<typename FuncType>
 	static void SplitBySubstringPrivate(
-		const SString& str, const SString& substr,
+		const TString& str, const TString& substr,
 		bool ignoreEmpty, bool caseSensitive,
 		SizeType maxSplits,
 		FuncType&& functor)
@@ -585,11 +588,11 @@ private:
 	DataType _data = {};
 };
 
-template<>
-struct TContainerTypeTraits<SString> : public TContainerTypeTraits<void>
+template<typename AllocatorT>
+struct TContainerTypeTraits<TString<AllocatorT>> : public TContainerTypeTraits<void>
 {
-	using ElementType = SString::CharType;
-	using AllocatorType = SString::DataType::AllocatorType;
+	using ElementType = typename TString<AllocatorT>::CharType;
+	using AllocatorType = AllocatorT;
 
 	enum
 	{
@@ -599,19 +602,24 @@ struct TContainerTypeTraits<SString> : public TContainerTypeTraits<void>
 	};
 };
 
+template<typename AllocatorT>
+struct TIsBitwiseRelocatable<TString<AllocatorT>> { enum { Value = TIsBitwiseRelocatable<typename TString<AllocatorT>::DataType>::Value }; };
+
 // Archive operator<< && operator>>
 ////////////////////////////////////////////
 
-FORCEINLINE_DEBUGGABLE static SArchive& operator<<(SArchive& ar, const SString& str)
+template<typename AllocatorT>
+FORCEINLINE_DEBUGGABLE static SArchive& operator<<(SArchive& ar, const TString<AllocatorT>& str)
 {
 	ar.Write(str.GetChars(), str.GetLength());
 	return ar;
 }
 
-FORCEINLINE_DEBUGGABLE static SArchive& operator>>(SArchive& ar, SString& str)
+template<typename AllocatorT>
+FORCEINLINE_DEBUGGABLE static SArchive& operator>>(SArchive& ar, TString<AllocatorT>& str)
 {
-	SString::DataType newData;
+	typename TString<AllocatorT>::DataType newData;
 	ar >> newData;
-	str = SString(Move(newData));
+	str = TString<AllocatorT>(Move(newData));
 	return ar;
 }
@@ -0,0 +1,341 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/Array.h"
+#include "ASTD/CString.h"
+#include "ASTD/Memory.h"
+#include "ASTD/String.h"
+
+// Buffered reader of string archives
+// * Keeps cursor over window of characters read from the archive, tokens are parsed in place
+// * Window grows when single token does not fit, so tokens are never truncated
+// * Archive is moved back to the reader position once reader is released (or destroyed)
+struct STextReader
+{
+	typedef SArchive::SizeType SizeType;
+
+	static constexpr SizeType DEFAULT_BUFFER_NUM = 16 << 10;
+
+	FORCEINLINE explicit STextReader(SArchive& ar, SizeType bufferNum = DEFAULT_BUFFER_NUM)
+		: _ar(ar)
+		, _startOffset(ar.GetOffset<tchar>())
+	{
+		// Extra character is reserved for terminator used while parsing
+		_buffer.AddUninitialized(SMath::Max<SizeType>(bufferNum, 64) + 1);
+
+		// Binary archive is never read, reader stays at the end
+		_isEnd = !CHECK(ar.IsString());
+	}
+
+	STextReader(const STextReader&) = delete;
+	STextReader& operator=(const STextReader&) = delete;
+
+	FORCEINLINE ~STextReader() { Release(); }
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE SArchive& GetArchive() const { return _ar; }
+
+	// Gets offset in characters of the reader in the archive
+	FORCEINLINE SizeType GetOffset() const { return _startOffset + _consumedNum - (_num - _pos); }
+
+	// Whether there are no more characters to read
+	FORCEINLINE bool IsEnd() { return _pos == _num && !RefillImpl(); }
+
+	// Moves archive to reader position and drops buffered characters
+	void Release()
+	{
+		if (_num > _pos)
+		{
+			_ar.SetOffset<tchar>(GetOffset());
+		}
+
+		_startOffset = GetOffset();
+		_consumedNum = 0;
+		_pos = _num = 0;
+		_isEnd = !_ar.IsString();
+	}
+
+	// Characters
+	/////////////////////////////////
+
+	FORCEINLINE bool Peek(tchar& outChar)
+	{
+		if (IsEnd()) return false;
+
+		outChar = _buffer[_pos];
+		return true;
+	}
+
+	FORCEINLINE bool ReadChar(tchar& outChar)
+	{
+		if (!Peek(outChar)) return false;
+
+		++_pos;
+		return true;
+	}
+
+	// Skips whitespace characters, returns number of skipped characters
+	FORCEINLINE SizeType SkipWhitespace()
+	{
+		const SizeType num = ScanImpl([](tchar character, SizeType) { return IsWhitespace(character); });
+		_pos += num;
+		return num;
+	}
+
+	// Skips characters till the end of the line (including new line)
+	FORCEINLINE void SkipLine()
+	{
+		_pos += ScanImpl([](tchar character, SizeType) { return character != CHAR_NEWLINE; });
+		if (_pos < _num) ++_pos;
+	}
+
+	// Tokens
+	/////////////////////////////////
+
+	// Reads characters till whitespace, skips leading whitespace
+	bool ReadToken(SString& outToken)
+	{
+		SkipWhitespace();
+
+		const SizeType num = ScanImpl([](tchar character, SizeType) { return !IsWhitespace(character); });
+		if (num == 0) return false;
+
+		outToken = SString(_buffer.GetData() + _pos, num);
+		_pos += num;
+		return true;
+	}
+
+	// Reads characters till the end of the line, new line (and preceding carriage return) is not included
+	bool ReadLine(SString& outLine)
+	{
+		if (IsEnd()) return false;
+
+		SizeType num = ScanImpl([](tchar character, SizeType) { return character != CHAR_NEWLINE; });
+		const SizeType lineNum = (num > 0 && _buffer[_pos + num - 1] == TEXT('\r')) ? num - 1 : num;
+
+		outLine = SString(_buffer.GetData() + _pos, lineNum);
+
+		if (_pos + num < _num) ++num;
+		_pos += num;
+		return true;
+	}
+
+	// Numbers
+	// * Skip leading whitespace, return false when there is no valid number (reader stays in front of it)
+	/////////////////////////////////
+
+	bool ReadUInt64(uint64& outValue)
+	{
+		SkipWhitespace();
+
+		const SizeType num = ScanImpl([](tchar character, SizeType idx) { return IsDigit(character) || (idx == 0 && character == TEXT('+')); });
+		if (!ParseUnsignedImpl(_buffer.GetData() + _pos, num, outValue))
+		{
+			return false;
+		}
+
+		_pos += num;
+		return true;
+	}
+
+	FORCEINLINE bool ReadInt64(int64& outValue) { return ReadSignedImpl(outValue, TLimits<int64>::Min, TLimits<int64>::Max); }
+
+	FORCEINLINE bool ReadInt32(int32& outValue)
+	{
+		int64 value;
+		if (!ReadSignedImpl(value, TLimits<int32>::Min, TLimits<int32>::Max))
+		{
+			return false;
+		}
+
+		outValue = (int32)value;
+		return true;
+	}
+
+	bool ReadDouble(double& outValue)
+	{
+		SkipWhitespace();
+
+		const SizeType num = ScanImpl([this](tchar character, SizeType idx) {
+			if (IsDigit(character) || character == TEXT('.')) return true;
+			else if (character == TEXT('e') || character == TEXT('E')) return idx > 0;
+
+			const tchar previous = idx > 0 ? _buffer[_pos + idx - 1] : TEXT('e');
+			return IsSign(character) && (previous == TEXT('e') || previous == TEXT('E'));
+		});
+
+		tchar* token = _buffer.GetData() + _pos;
+		if (num == 0 || !ContainsDigitImpl(token, num))
+		{
+			return false;
+		}
+
+		// Window always has space for terminator
+		const tchar next = token[num];
+		token[num] = CHAR_TERM;
+		outValue = SCString::ToDouble(token);
+		token[num] = next;
+
+		_pos += num;
+		return true;
+	}
+
+	// Helpers
+	/////////////////////////////////
+
+	FORCEINLINE static bool IsWhitespace(tchar character)
+	{
+		return character == TEXT(' ') || character == TEXT('\t') || character == CHAR_NEWLINE
+			|| character == TEXT('\r') || character == TEXT('\v') || character == TEXT('\f');
+	}
+
+	FORCEINLINE static bool IsDigit(tchar character) { return character >= TEXT('0') && character <= TEXT('9'); }
+	FORCEINLINE static bool IsSign(tchar character) { return character == TEXT('-') || character == TEXT('+'); }
+
+private:
+
+	// Counts characters from the cursor that pass the predicate, refills window when needed
+	// Pred: (tchar character, SizeType idx) -> bool
+	template<typename PredT>
+	SizeType ScanImpl(PredT&& predicate)
+	{
+		SizeType num = 0;
+		while (true)
+		{
+			for (; _pos + num < _num; ++num)
+			{
+				if (!predicate(_buffer[_pos + num], num))
+				{
+					return num;
+				}
+			}
+
+			if (!RefillImpl())
+			{
+				return num;
+			}
+		}
+	}
+
+	// Moves unread characters to the front and reads more, grows window when it is full
+	bool RefillImpl()
+	{
+		if (_isEnd)
+		{
+			return false;
+		}
+
+		if (_pos > 0)
+		{
+			SMemory::Move(_buffer.GetData(), _buffer.GetData() + _pos, (_num - _pos) * sizeof(tchar));
+			_num -= _pos;
+			_pos = 0;
+		}
+
+		const SizeType capacity = _buffer.GetNum() - 1;
+		if (_num == capacity)
+		{
+			_buffer.AddUninitialized(capacity);
+		}
+
+		const SizeType readNum = _ar.Read(_buffer.GetData() + _num, _buffer.GetNum() - 1 - _num);
+		if (readNum <= 0)
+		{
+			_isEnd = true;
+			return false;
+		}
+
+		_num += readNum;
+		_consumedNum += readNum;
+		return true;
+	}
+
+	bool ReadSignedImpl(int64& outValue, int64 min, int64 max)
+	{
+		SkipWhitespace();
+
+		const SizeType num = ScanImpl([](tchar character, SizeType idx) { return IsDigit(character) || (idx == 0 && IsSign(character)); });
+
+		const tchar* token = _buffer.GetData() + _pos;
+		const bool negative = num > 0 && token[0] == TEXT('-');
+
+		uint64 value;
+		if (!ParseUnsignedImpl(token, num, value))
+		{
+			return false;
+		}
+		else if (negative ? value > (uint64)0 - (uint64)min : value > (uint64)max)
+		{
+			return false;
+		}
+
+		outValue = negative ? (int64)((uint64)0 - value) : (int64)value;
+		_pos += num;
+		return true;
+	}
+
+	FORCEINLINE static bool ContainsDigitImpl(const tchar* token, SizeType num)
+	{
+		for (SizeType i = 0; i < num; ++i)
+		{
+			if (IsDigit(token[i])) return true;
+		}
+
+		return false;
+	}
+
+	// Parses [sign]digits, fails on overflow or when there are no digits
+	static bool ParseUnsignedImpl(const tchar* token, SizeType num, uint64& outValue)
+	{
+		const SizeType start = (num > 0 && IsSign(token[0])) ? 1 : 0;
+		if (start == num)
+		{
+			return false;
+		}
+
+		uint64 value = 0;
+		for (SizeType i = start; i < num; ++i)
+		{
+			const uint64 digit = token[i] - TEXT('0');
+			if (value > (TLimits<uint64>::Max - digit) / 10)
+			{
+				return false;
+			}
+
+			value = value * 10 + digit;
+		}
+
+		outValue = value;
+		return true;
+	}
+
+	SArchive& _ar;
+
+	// Window
+	TArray<tchar> _buffer = {};
+	SizeType _pos = 0;
+	SizeType _num = 0;
+
+	// Archive position in characters when window was empty
+	SizeType _startOffset = 0;
+
+	// Number of characters read from the archive since start offset
+	SizeType _consumedNum = 0;
+
+	bool _isEnd = false;
+};
+
+// Reader operator>>
+////////////////////////////////////////////
+
+FORCEINLINE_DEBUGGABLE static STextReader& operator>>(STextReader& reader, int32& val) { reader.ReadInt32(val); return reader; }
+FORCEINLINE_DEBUGGABLE static STextReader& operator>>(STextReader& reader, int64& val) { reader.ReadInt64(val); return reader; }
+FORCEINLINE_DEBUGGABLE static STextReader& operator>>(STextReader& reader, uint64& val) { reader.ReadUInt64(val); return reader; }
+FORCEINLINE_DEBUGGABLE static STextReader& operator>>(STextReader& reader, double& val) { reader.ReadDouble(val); return reader; }
+FORCEINLINE_DEBUGGABLE static STextReader& operator>>(STextReader& reader, SString& val) { reader.ReadToken(val); return reader; }
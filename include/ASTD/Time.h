@@ -0,0 +1,193 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include PLATFORM_HEADER(Time)
+
+#if ARCHITECTURE_X86
+	#if COMPILER_MSVC
+		#include <intrin.h>
+	#else
+		#include <x86intrin.h>
+	#endif
+#endif
+
+typedef PLATFORM_PREFIXED_TYPE(S, PlatformTime) SPlatformTime;
+
+// Clocks and time conversions
+// * All clocks return integer nanoseconds
+// * Monotonic clocks are for measuring durations, wall clocks for timestamps since epoch (UTC)
+// * Coarse clocks are the cheapest, but have precision of few milliseconds
+// * Cycle counter is the cheapest precise clock, see ReadCycleCounter
+struct STime : public SPlatformTime
+{
+	static constexpr int64 NS_PER_US = 1000;
+	static constexpr int64 NS_PER_MS = 1000 * NS_PER_US;
+	static constexpr int64 NS_PER_SECOND = 1000 * NS_PER_MS;
+
+	// How long the cycle counter is measured against monotonic clock
+	static constexpr int64 CALIBRATION_NS = 10 * NS_PER_MS;
+
+	// Conversions
+	/////////////////////////////////
+
+	FORCEINLINE static constexpr int64 NanosecondsToMicroseconds(int64 ns) { return ns / NS_PER_US; }
+	FORCEINLINE static constexpr int64 NanosecondsToMilliseconds(int64 ns) { return ns / NS_PER_MS; }
+	FORCEINLINE static constexpr double NanosecondsToSeconds(int64 ns) { return (double)ns / NS_PER_SECOND; }
+
+	FORCEINLINE static constexpr int64 MicrosecondsToNanoseconds(int64 us) { return us * NS_PER_US; }
+	FORCEINLINE static constexpr int64 MillisecondsToNanoseconds(int64 ms) { return ms * NS_PER_MS; }
+	FORCEINLINE static constexpr int64 SecondsToNanoseconds(double seconds) { return (int64)(seconds * NS_PER_SECOND); }
+
+	// Cycle counter
+	/////////////////////////////////
+
+	// Reads CPU counter (rdtsc on x86, cntvct on arm64) without serialization
+	// * Falls back to monotonic clock on other architectures
+	// * Counter is assumed to be constant rate and synchronized between cores, see ECpuFeature::InvariantTSC
+	FORCEINLINE static int64 ReadCycleCounter()
+	{
+#if ARCHITECTURE_X86
+		return (int64)__rdtsc();
+#elif ARCHITECTURE_ARM && ARCHITECTURE_64 && !COMPILER_MSVC
+		int64 value;
+		asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+		return value;
+#else
+		return GetMonotonicNanoseconds();
+#endif
+	}
+
+	// Gets number of cycle counter ticks per second
+	// * First call calibrates counter against monotonic clock, which takes CALIBRATION_NS
+	FORCEINLINE static double GetCycleFrequency() { return GetCalibrationImpl().Frequency; }
+
+	// Converts cycle counter difference to nanoseconds
+	FORCEINLINE static int64 CyclesToNanoseconds(int64 cycles) { return (int64)(cycles * GetCalibrationImpl().NsPerCycle); }
+
+	// Converts cycle counter value to monotonic clock time, see GetMonotonicNanoseconds
+	FORCEINLINE static int64 CycleCounterToMonotonicNanoseconds(int64 cycles)
+	{
+		const SCalibrationImpl& calibration = GetCalibrationImpl();
+		return calibration.BaseNs + (int64)((cycles - calibration.BaseCycles) * calibration.NsPerCycle);
+	}
+
+	// Calibrates cycle counter, so it does not happen on the first conversion
+	FORCEINLINE static void Calibrate() { GetCalibrationImpl(); }
+
+private:
+
+	struct SCalibrationImpl
+	{
+		double Frequency;
+		double NsPerCycle;
+		int64 BaseCycles;
+		int64 BaseNs;
+	};
+
+	static const SCalibrationImpl& GetCalibrationImpl()
+	{
+		static const SCalibrationImpl calibration = []() {
+			SCalibrationImpl result;
+			result.BaseNs = GetMonotonicNanoseconds();
+			result.BaseCycles = ReadCycleCounter();
+
+#if ARCHITECTURE_ARM && ARCHITECTURE_64 && !COMPILER_MSVC
+			// Frequency is reported by the counter itself
+			int64 frequency;
+			asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+			result.Frequency = (double)frequency;
+#elif ARCHITECTURE_X86
+			int64 endNs;
+			do
+			{
+				endNs = GetMonotonicNanoseconds();
+			}
+			while (endNs - result.BaseNs < CALIBRATION_NS);
+
+			const int64 endCycles = ReadCycleCounter();
+			result.Frequency = (double)(endCycles - result.BaseCycles) * NS_PER_SECOND / (endNs - result.BaseNs);
+#else
+			result.Frequency = (double)NS_PER_SECOND;
+#endif
+
+			result.NsPerCycle = NS_PER_SECOND / result.Frequency;
+			return result;
+		}();
+
+		return calibration;
+	}
+};
+
+// Measures elapsed time with monotonic clock
+// * Time is accumulated over multiple Start/Stop intervals
+struct SStopwatch
+{
+	// Creates stopwatch, optionally started
+	FORCEINLINE explicit SStopwatch(bool start = false)
+	{
+		if (start)
+		{
+			Start();
+		}
+	}
+
+	// Running
+	/////////////////////////////////
+
+	FORCEINLINE bool IsRunning() const { return _startNs >= 0; }
+
+	FORCEINLINE void Start()
+	{
+		if (!IsRunning())
+		{
+			_startNs = STime::GetMonotonicNanoseconds();
+		}
+	}
+
+	FORCEINLINE void Stop()
+	{
+		if (IsRunning())
+		{
+			_elapsedNs += STime::GetMonotonicNanoseconds() - _startNs;
+			_startNs = -1;
+		}
+	}
+
+	// Stops and clears elapsed time
+	FORCEINLINE void Reset()
+	{
+		_elapsedNs = 0;
+		_startNs = -1;
+	}
+
+	// Clears elapsed time and starts again, returns elapsed time before the restart
+	FORCEINLINE int64 Restart()
+	{
+		const int64 nowNs = STime::GetMonotonicNanoseconds();
+		const int64 elapsedNs = _elapsedNs + (IsRunning() ? nowNs - _startNs : 0);
+
+		_elapsedNs = 0;
+		_startNs = nowNs;
+		return elapsedNs;
+	}
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE int64 GetElapsedNanoseconds() const
+	{
+		return _elapsedNs + (IsRunning() ? STime::GetMonotonicNanoseconds() - _startNs : 0);
+	}
+
+	FORCEINLINE int64 GetElapsedMicroseconds() const { return STime::NanosecondsToMicroseconds(GetElapsedNanoseconds()); }
+	FORCEINLINE int64 GetElapsedMilliseconds() const { return STime::NanosecondsToMilliseconds(GetElapsedNanoseconds()); }
+	FORCEINLINE double GetElapsedSeconds() const { return STime::NanosecondsToSeconds(GetElapsedNanoseconds()); }
+
+private:
+
+	int64 _elapsedNs = 0;
+	int64 _startNs = -1;
+};
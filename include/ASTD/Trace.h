@@ -0,0 +1,505 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/Array.h"
+#include "ASTD/CString.h"
+#include "ASTD/Memory.h"
+#include "ASTD/Time.h"
+#include "ASTD/VarInt.h"
+
+// TODO: Replace with custom implementation
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+
+// Measures the rest of the enclosing scope
+// * Name has to be string literal (or other static storage string), only its pointer is recorded
+// * Compiled out unless ASTD_TRACE is enabled
+// * Example: TRACE_SCOPE("LoadLevel");
+#if ASTD_TRACE
+	#define TRACE_SCOPE(name) STraceScope CONCAT_EXPAND(traceScope_, __LINE__)(name)
+#else
+	#define TRACE_SCOPE(name)
+#endif
+
+// Single measured scope, times are in monotonic clock nanoseconds (see STime)
+struct STraceEvent
+{
+	const char* Name;
+	int64 BeginNs;
+	int64 DurationNs;
+};
+
+// Trace recording and export
+// * Every thread records into its own lock-free ring buffer, events are dropped when the buffer is full
+// * Writers drain all buffers, so they should be called regularly (ex. once per frame) for long captures
+// * Buffer of exited thread is reused by the next new thread once it is drained
+struct STrace
+{
+	// Events per thread buffer, has to be power of two
+	static constexpr int64 BUFFER_EVENTS_NUM = 1 << 14;
+
+	// Binary format
+	// * Header is BINARY_MAGIC followed by uint32 BINARY_VERSION
+	// * Records start with uint8 type, all integers after it are varints (see VarInt.h)
+	// * Name: id, length, chars (ids are assigned in order from 0)
+	// * Thread: id, applies to all following events
+	// * Event: name id, zigzag begin delta from previous event, duration
+	static constexpr uint32 BINARY_MAGIC = 0x43525441; // "ATRC"
+	static constexpr uint32 BINARY_VERSION = 1;
+
+	enum class EBinaryRecord : uint8
+	{
+		Name = 1,
+		Thread,
+		Event
+	};
+
+	// Recording
+	/////////////////////////////////
+
+	// Recording can be paused at runtime, already recorded events are kept
+	FORCEINLINE static bool IsEnabled() { return GetEnabledImpl().load(std::memory_order_relaxed); }
+	FORCEINLINE static void SetEnabled(bool value) { GetEnabledImpl().store(value, std::memory_order_relaxed); }
+
+	// Gets timestamp used by Record, in cycle counter ticks
+	// * Ticks are converted to nanoseconds only when events are written
+	FORCEINLINE static int64 GetTimestamp() { return STime::ReadCycleCounter(); }
+
+	// Records event into the calling thread buffer, see GetTimestamp
+	static void Record(const char* name, int64 begin, int64 end)
+	{
+		SThreadBuffer* buffer = GetThreadBufferImpl();
+		if (!buffer)
+		{
+			// Thread is exiting
+			return;
+		}
+
+		// Only this thread moves the head, writers only move the tail
+		const uint64 head = buffer->Head.load(std::memory_order_relaxed);
+		if (head - buffer->Tail.load(std::memory_order_acquire) >= (uint64)BUFFER_EVENTS_NUM)
+		{
+			buffer->DroppedNum.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		SRecordedEvent& event = buffer->Events[head & (BUFFER_EVENTS_NUM - 1)];
+		event.Name = name;
+		event.Begin = begin;
+		// Counter of other core may be slightly behind when thread migrates
+		event.Duration = end > begin ? end - begin : 0;
+
+		buffer->Head.store(head + 1, std::memory_order_release);
+	}
+
+	// Gets number of events dropped because some buffer was full
+	static int64 GetDroppedNum()
+	{
+		int64 result = 0;
+		for (SThreadBuffer* buffer = GetBuffersImpl().load(std::memory_order_acquire); buffer; buffer = buffer->Next)
+		{
+			result += buffer->DroppedNum.load(std::memory_order_relaxed);
+		}
+
+		return result;
+	}
+
+	// Writing
+	/////////////////////////////////
+
+	// Drains recorded events as complete Chrome trace JSON document (chrome://tracing, Perfetto)
+	// * Returns number of written events
+	static int64 WriteChromeJson(SArchive& ar)
+	{
+		std::lock_guard<std::mutex> lock(GetWriterMutexImpl());
+
+		SWriterImpl writer(ar);
+		writer.Write("{\"traceEvents\":[\n");
+
+		bool isFirst = true;
+		const int64 eventsNum = DrainImpl([&writer, &isFirst](uint32 threadId, const STraceEvent* event) {
+			char line[128];
+			int32 num;
+			if (event)
+			{
+				// Chrome expects microseconds
+				num = snprintf(line, sizeof(line), "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lld.%03lld,\"dur\":%lld.%03lld,\"name\":\"",
+					isFirst ? "" : ",\n", threadId,
+					(long long)(event->BeginNs / 1000), (long long)(event->BeginNs % 1000),
+					(long long)(event->DurationNs / 1000), (long long)(event->DurationNs % 1000));
+
+				writer.Write(line, num);
+				writer.WriteEscaped(event->Name);
+				writer.Write("\"}");
+			}
+			else
+			{
+				num = snprintf(line, sizeof(line), "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"Thread %u\"}}",
+					isFirst ? "" : ",\n", threadId, threadId);
+
+				writer.Write(line, num);
+			}
+
+			isFirst = false;
+		});
+
+		writer.Write("\n],\"displayTimeUnit\":\"ns\"}\n");
+		return eventsNum;
+	}
+
+	// Drains recorded events in compact binary format, see BINARY_MAGIC
+	// * Returns number of written events
+	static int64 WriteBinary(SArchive& ar)
+	{
+		std::lock_guard<std::mutex> lock(GetWriterMutexImpl());
+
+		SWriterImpl writer(ar);
+		writer.Write(&BINARY_MAGIC, sizeof(BINARY_MAGIC));
+		writer.Write(&BINARY_VERSION, sizeof(BINARY_VERSION));
+
+		SNameTableImpl names;
+		int64 previousBeginNs = 0;
+
+		const int64 eventsNum = DrainImpl([&writer, &names, &previousBeginNs](uint32 threadId, const STraceEvent* event) {
+			if (!event)
+			{
+				writer.WriteRecord(EBinaryRecord::Thread);
+				writer.WriteVarInt(threadId);
+				return;
+			}
+
+			bool isNew;
+			const uint32 nameId = names.FindOrAdd(event->Name, isNew);
+			if (isNew)
+			{
+				const int32 length = SCString::GetLength(event->Name);
+
+				writer.WriteRecord(EBinaryRecord::Name);
+				writer.WriteVarInt(nameId);
+				writer.WriteVarInt(length);
+				writer.Write(event->Name, length);
+			}
+
+			writer.WriteRecord(EBinaryRecord::Event);
+			writer.WriteVarInt(nameId);
+			writer.WriteVarInt(SVarInt::ZigZagEncode(event->BeginNs - previousBeginNs));
+			writer.WriteVarInt(event->DurationNs);
+
+			previousBeginNs = event->BeginNs;
+		});
+
+		return eventsNum;
+	}
+
+private:
+
+	struct SRecordedEvent
+	{
+		const char* Name;
+		int64 Begin;
+		int64 Duration;
+	};
+
+	struct SThreadBuffer
+	{
+		SRecordedEvent Events[BUFFER_EVENTS_NUM];
+
+		alignas(64) std::atomic<uint64> Head = { 0 };
+		std::atomic<int64> DroppedNum = { 0 };
+
+		alignas(64) std::atomic<uint64> Tail = { 0 };
+
+		std::atomic<bool> IsOwned = { false };
+		uint32 ThreadId = 0;
+		SThreadBuffer* Next = nullptr;
+	};
+
+	// Plain data, so it stays usable while other thread_local objects are destroyed
+	struct SThreadState
+	{
+		SThreadBuffer* Buffer;
+		bool IsExiting;
+	};
+
+	// Returns buffer to the pool once its thread exits
+	struct SThreadBufferReleaser
+	{
+		FORCEINLINE SThreadBufferReleaser(SThreadState& state) : _state(state) {}
+
+		~SThreadBufferReleaser()
+		{
+			SThreadBuffer* buffer = _state.Buffer;
+			_state.Buffer = nullptr;
+			_state.IsExiting = true;
+
+			buffer->IsOwned.store(false, std::memory_order_release);
+		}
+
+	private:
+
+		SThreadState& _state;
+	};
+
+	// Buffers are never freed, events of exited threads can still be written
+	static std::atomic<SThreadBuffer*>& GetBuffersImpl()
+	{
+		static std::atomic<SThreadBuffer*> buffers = { nullptr };
+		return buffers;
+	}
+
+	static std::atomic<bool>& GetEnabledImpl()
+	{
+		static std::atomic<bool> isEnabled = { true };
+		return isEnabled;
+	}
+
+	static std::mutex& GetWriterMutexImpl()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	FORCEINLINE static SThreadBuffer* GetThreadBufferImpl()
+	{
+		thread_local SThreadState state = {};
+		if (!state.Buffer && !state.IsExiting)
+		{
+			state.Buffer = AcquireBufferImpl();
+			thread_local SThreadBufferReleaser releaser(state);
+		}
+
+		return state.Buffer;
+	}
+
+	static SThreadBuffer* AcquireBufferImpl()
+	{
+		static std::atomic<uint32> lastThreadId = { 0 };
+		std::atomic<SThreadBuffer*>& buffers = GetBuffersImpl();
+
+		// Drained buffer of exited thread can be reused, its old events can not be attributed to the new thread
+		SThreadBuffer* buffer = buffers.load(std::memory_order_acquire);
+		for (; buffer; buffer = buffer->Next)
+		{
+			bool expected = false;
+			if (buffer->Head.load(std::memory_order_relaxed) == buffer->Tail.load(std::memory_order_acquire) &&
+				buffer->IsOwned.compare_exchange_strong(expected, true, std::memory_order_acquire))
+			{
+				if (buffer->Head.load(std::memory_order_relaxed) == buffer->Tail.load(std::memory_order_acquire))
+				{
+					break;
+				}
+
+				buffer->IsOwned.store(false, std::memory_order_release);
+			}
+		}
+
+		if (!buffer)
+		{
+			buffer = new SThreadBuffer();
+			buffer->IsOwned.store(true, std::memory_order_relaxed);
+
+			SThreadBuffer* head = buffers.load(std::memory_order_relaxed);
+			do
+			{
+				buffer->Next = head;
+			}
+			while (!buffers.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		buffer->ThreadId = lastThreadId.fetch_add(1, std::memory_order_relaxed) + 1;
+		return buffer;
+	}
+
+	// Calls "func" with null event once per thread, followed by its events
+	template<typename FuncT>
+	static int64 DrainImpl(FuncT&& func)
+	{
+		int64 eventsNum = 0;
+		for (SThreadBuffer* buffer = GetBuffersImpl().load(std::memory_order_acquire); buffer; buffer = buffer->Next)
+		{
+			// Thread id is stable while there are events, buffer is only reused once drained
+			const uint64 head = buffer->Head.load(std::memory_order_acquire);
+			const uint64 tail = buffer->Tail.load(std::memory_order_relaxed);
+			if (head == tail)
+			{
+				continue;
+			}
+
+			func(buffer->ThreadId, nullptr);
+			for (uint64 pos = tail; pos < head; ++pos)
+			{
+				const SRecordedEvent& recorded = buffer->Events[pos & (BUFFER_EVENTS_NUM - 1)];
+
+				STraceEvent event;
+				event.Name = recorded.Name;
+				event.BeginNs = STime::CycleCounterToMonotonicNanoseconds(recorded.Begin);
+				event.DurationNs = STime::CyclesToNanoseconds(recorded.Duration);
+
+				func(buffer->ThreadId, &event);
+			}
+
+			buffer->Tail.store(head, std::memory_order_release);
+			eventsNum += head - tail;
+		}
+
+		return eventsNum;
+	}
+
+	// Batches small writes into bigger archive writes
+	struct SWriterImpl
+	{
+		FORCEINLINE SWriterImpl(SArchive& ar) : _ar(ar) {}
+		FORCEINLINE ~SWriterImpl() { FlushImpl(); }
+
+		FORCEINLINE void Write(const char* text) { Write(text, SCString::GetLength(text)); }
+
+		void Write(const void* data, int64 size)
+		{
+			if (_buffer.GetNum() + size > BUFFER_SIZE)
+			{
+				FlushImpl();
+			}
+
+			_buffer.Append((const uint8*)data, size);
+		}
+
+		FORCEINLINE void WriteRecord(EBinaryRecord record) { const uint8 value = (uint8)record; Write(&value, 1); }
+
+		FORCEINLINE void WriteVarInt(uint64 value)
+		{
+			uint8 encoded[SVarInt::MAX_BYTES_64];
+			Write(encoded, SVarInt::Encode(value, encoded));
+		}
+
+		// Writes JSON string content
+		void WriteEscaped(const char* text)
+		{
+			for (const char* c = text; *c != '\0'; ++c)
+			{
+				if (*c == '"' || *c == '\\')
+				{
+					Write("\\", 1);
+				}
+				else if ((uint8)*c < 0x20)
+				{
+					continue;
+				}
+
+				Write(c, 1);
+			}
+		}
+
+	private:
+
+		static constexpr int64 BUFFER_SIZE = 64 << 10;
+
+		void FlushImpl()
+		{
+			if (!_buffer.IsEmpty())
+			{
+				_ar.WriteBytes(_buffer.GetData(), _buffer.GetNum());
+				_buffer.Reset();
+			}
+		}
+
+		SArchive& _ar;
+		TArray<uint8> _buffer;
+	};
+
+	// Name ids for binary format, names are compared by pointer
+	struct SNameTableImpl
+	{
+		uint32 FindOrAdd(const char* name, bool& outIsNew)
+		{
+			if ((int64)(_num + 1) * 2 > _slots.GetNum())
+			{
+				GrowImpl();
+			}
+
+			const int32 mask = _slots.GetNum() - 1;
+			for (int32 idx = HashImpl(name) & mask; ; idx = (idx + 1) & mask)
+			{
+				SSlot& slot = _slots[idx];
+				if (slot.Name == name)
+				{
+					outIsNew = false;
+					return slot.Id;
+				}
+				else if (!slot.Name)
+				{
+					slot.Name = name;
+					slot.Id = _num++;
+
+					outIsNew = true;
+					return slot.Id;
+				}
+			}
+		}
+
+	private:
+
+		struct SSlot
+		{
+			const char* Name = nullptr;
+			uint32 Id = 0;
+		};
+
+		FORCEINLINE static int32 HashImpl(const char* name) { return (int32)(((uint64)name * 0x9E3779B97F4A7C15ull) >> 40); }
+
+		void GrowImpl()
+		{
+			TArray<SSlot> oldSlots = Move(_slots);
+			_slots.AddDefaulted(oldSlots.IsEmpty() ? 64 : oldSlots.GetNum() * 2);
+
+			const int32 mask = _slots.GetNum() - 1;
+			for (const SSlot& oldSlot : oldSlots)
+			{
+				if (oldSlot.Name)
+				{
+					int32 idx = HashImpl(oldSlot.Name) & mask;
+					while (_slots[idx].Name)
+					{
+						idx = (idx + 1) & mask;
+					}
+
+					_slots[idx] = oldSlot;
+				}
+			}
+		}
+
+		TArray<SSlot> _slots;
+		uint32 _num = 0;
+	};
+};
+
+// Records event of its lifetime, see TRACE_SCOPE
+struct STraceScope
+{
+	FORCEINLINE explicit STraceScope(const char* name)
+		: _name(name)
+		, _isRecording(STrace::IsEnabled())
+		, _begin(_isRecording ? STrace::GetTimestamp() : 0)
+	{}
+
+	FORCEINLINE ~STraceScope()
+	{
+		if (_isRecording)
+		{
+			STrace::Record(_name, _begin, STrace::GetTimestamp());
+		}
+	}
+
+	STraceScope(const STraceScope&) = delete;
+	STraceScope& operator=(const STraceScope&) = delete;
+
+private:
+
+	const char* _name;
+	bool _isRecording;
+	int64 _begin;
+};
@@ -162,10 +162,19 @@ struct TLimits
 
 	static constexpr bool IsSigned = TIsSigned<T>::Value;
 
-	static constexpr T Max = (T)((uint64)1 << (sizeof(T) * 8 - (IsSigned ? 1 : 0))) - 1;
-	static constexpr T Min = IsSigned ? (-(int64)((uint64)1 << (sizeof(T) * 8 - 1))) : 0;
+	static constexpr T Max = (T)((~(uint64)0 >> (64 - sizeof(T) * 8)) >> (IsSigned ? 1 : 0));
+	static constexpr T Min = IsSigned ? (T)(-(int64)Max - 1) : (T)0;
 };
 
+// [Bitwise Relocatable]
+// Tells whether object can be moved to another address by copying its bytes
+// * Source memory is treated as uninitialized afterwards, no destructor is called on it
+// * Containers (ex. TArray) use it to grow with realloc/memmove instead of moving every element
+// * Specialize for types that do not point into themselves (ex. TArray, TUniquePtr)
+
+template<typename T>
+struct TIsBitwiseRelocatable { enum { Value = TIsTriviallyCopyable<T>::Value }; };
+
 // [Type Traits]
 // Tells information about the type
 
@@ -187,6 +196,7 @@ struct TTypeTraits
 
 		IsBitwiseCopyable = !HasCopyConstructor && !HasCopyAssign,
 		IsBitwiseMovable = !HasMoveConstructor && !HasMoveAssign,
+		IsBitwiseRelocatable = TIsBitwiseRelocatable<T>::Value,
 		IsBitwiseComparable = IsFundamental || IsEnum || !THasEqualOperator<T>::Value
 	};
 };
@@ -0,0 +1,312 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/_internal/SharedReferencer.h"
+
+// Deleter used by TUniquePtr by default
+template<typename T>
+struct TDefaultDelete
+{
+	FORCEINLINE constexpr TDefaultDelete() = default;
+
+	template<typename OtherT, typename TEnableIf<TIsDerivedFrom<OtherT, T>::Value>::Type* = nullptr>
+	FORCEINLINE constexpr TDefaultDelete(const TDefaultDelete<OtherT>&) {}
+
+	FORCEINLINE void operator()(T* object) const
+	{
+		static_assert(sizeof(T) > 0, "Can not delete incomplete type");
+		delete object;
+	}
+};
+
+template<typename T>
+struct TDefaultDelete<T[]>
+{
+	FORCEINLINE constexpr TDefaultDelete() = default;
+
+	FORCEINLINE void operator()(T* objects) const
+	{
+		static_assert(sizeof(T) > 0, "Can not delete incomplete type");
+		delete[] objects;
+	}
+};
+
+// Equivalent of std's unique_ptr
+// * Single owner, can only be moved
+// * Stateless deleter takes no space, so pointer has size of raw pointer
+// * Bitwise relocatable, arrays of unique pointers grow without touching the objects
+template<typename T, typename DeleterT>
+class TUniquePtr : private _NShared::TDeleterStorage<DeleterT>
+{
+	template<typename OtherT, typename OtherDeleterT> friend class TUniquePtr;
+
+	typedef _NShared::TDeleterStorage<DeleterT> DeleterStorageType;
+
+public:
+
+	// Typedefs
+	/////////////////////////////////
+
+	typedef T ObjectType;
+	typedef DeleterT DeleterType;
+
+	// Constructors
+	/////////////////////////////////
+
+	FORCEINLINE TUniquePtr() : DeleterStorageType(DeleterT()) {}
+	FORCEINLINE TUniquePtr(decltype(nullptr)) : DeleterStorageType(DeleterT()) {}
+	FORCEINLINE explicit TUniquePtr(ObjectType* object) : DeleterStorageType(DeleterT()), _object(object) {}
+
+	template<typename OtherDeleterT>
+	FORCEINLINE TUniquePtr(ObjectType* object, OtherDeleterT&& deleter) : DeleterStorageType(Forward<OtherDeleterT>(deleter)), _object(object) {}
+
+	// Copy/Move constructors
+	/////////////////////////////////
+
+	TUniquePtr(const TUniquePtr&) = delete;
+
+	FORCEINLINE TUniquePtr(TUniquePtr&& other) : DeleterStorageType(Move(other.GetDeleter())), _object(other.Release()) {}
+
+	template<typename OtherT, typename OtherDeleterT, typename TEnableIf<TIsDerivedFrom<OtherT, T>::Value>::Type* = nullptr>
+	FORCEINLINE TUniquePtr(TUniquePtr<OtherT, OtherDeleterT>&& other) : DeleterStorageType(Move(other.GetDeleter())), _object(other.Release()) {}
+
+	// Destructor
+	/////////////////////////////////
+
+	FORCEINLINE ~TUniquePtr() { Reset(); }
+
+	// Conversion operators
+	/////////////////////////////////
+
+	FORCEINLINE explicit operator bool() const { return IsValid(); }
+
+	// Comparison operators
+	/////////////////////////////////
+
+	FORCEINLINE bool operator==(const TUniquePtr& other) const { return _object == other._object; }
+	FORCEINLINE bool operator!=(const TUniquePtr& other) const { return !operator==(other); }
+
+	// Assignment operators
+	/////////////////////////////////
+
+	TUniquePtr& operator=(const TUniquePtr&) = delete;
+
+	FORCEINLINE TUniquePtr& operator=(decltype(nullptr)) { Reset(); return *this; }
+
+	FORCEINLINE TUniquePtr& operator=(TUniquePtr&& other)
+	{
+		if (&other != this)
+		{
+			Reset(other.Release());
+			GetDeleter() = Move(other.GetDeleter());
+		}
+
+		return *this;
+	}
+
+	template<typename OtherT, typename OtherDeleterT, typename TEnableIf<TIsDerivedFrom<OtherT, T>::Value>::Type* = nullptr>
+	FORCEINLINE TUniquePtr& operator=(TUniquePtr<OtherT, OtherDeleterT>&& other)
+	{
+		Reset(other.Release());
+		GetDeleter() = Move(other.GetDeleter());
+		return *this;
+	}
+
+	// Pointer operators
+	/////////////////////////////////
+
+	FORCEINLINE ObjectType* operator->() const { return _object; }
+	FORCEINLINE ObjectType& operator*() const { return *_object; }
+
+	// Validation
+	/////////////////////////////////
+
+	FORCEINLINE bool IsValid() const { return _object != nullptr; }
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE ObjectType* Get() const { return _object; }
+	FORCEINLINE ObjectType& GetRef() const { return *_object; }
+
+	FORCEINLINE DeleterType& GetDeleter() { return DeleterStorageType::GetDeleter(); }
+	FORCEINLINE const DeleterType& GetDeleter() const { return DeleterStorageType::GetDeleter(); }
+
+	// Other
+	/////////////////////////////////
+
+	// Gives up ownership without deleting the object
+	FORCEINLINE ObjectType* Release()
+	{
+		ObjectType* object = _object;
+		_object = nullptr;
+		return object;
+	}
+
+	// Deletes owned object and takes ownership of the new one
+	FORCEINLINE void Reset(ObjectType* object = nullptr)
+	{
+		ObjectType* previous = _object;
+		_object = object;
+
+		if (previous) GetDeleter()(previous);
+	}
+
+private:
+
+	ObjectType* _object = nullptr;
+};
+
+// Unique pointer to array allocated with new[]
+template<typename T, typename DeleterT>
+class TUniquePtr<T[], DeleterT> : private _NShared::TDeleterStorage<DeleterT>
+{
+	typedef _NShared::TDeleterStorage<DeleterT> DeleterStorageType;
+
+public:
+
+	// Typedefs
+	/////////////////////////////////
+
+	typedef T ObjectType;
+	typedef DeleterT DeleterType;
+
+	// Constructors
+	/////////////////////////////////
+
+	FORCEINLINE TUniquePtr() : DeleterStorageType(DeleterT()) {}
+	FORCEINLINE TUniquePtr(decltype(nullptr)) : DeleterStorageType(DeleterT()) {}
+	FORCEINLINE explicit TUniquePtr(ObjectType* objects) : DeleterStorageType(DeleterT()), _objects(objects) {}
+
+	template<typename OtherDeleterT>
+	FORCEINLINE TUniquePtr(ObjectType* objects, OtherDeleterT&& deleter) : DeleterStorageType(Forward<OtherDeleterT>(deleter)), _objects(objects) {}
+
+	// Copy/Move constructors
+	/////////////////////////////////
+
+	TUniquePtr(const TUniquePtr&) = delete;
+
+	FORCEINLINE TUniquePtr(TUniquePtr&& other) : DeleterStorageType(Move(other.GetDeleter())), _objects(other.Release()) {}
+
+	// Destructor
+	/////////////////////////////////
+
+	FORCEINLINE ~TUniquePtr() { Reset(); }
+
+	// Conversion operators
+	/////////////////////////////////
+
+	FORCEINLINE explicit operator bool() const { return IsValid(); }
+
+	// Comparison operators
+	/////////////////////////////////
+
+	FORCEINLINE bool operator==(const TUniquePtr& other) const { return _objects == other._objects; }
+	FORCEINLINE bool operator!=(const TUniquePtr& other) const { return !operator==(other); }
+
+	// Assignment operators
+	/////////////////////////////////
+
+	TUniquePtr& operator=(const TUniquePtr&) = delete;
+
+	FORCEINLINE TUniquePtr& operator=(decltype(nullptr)) { Reset(); return *this; }
+
+	FORCEINLINE TUniquePtr& operator=(TUniquePtr&& other)
+	{
+		if (&other != this)
+		{
+			Reset(other.Release());
+			GetDeleter() = Move(other.GetDeleter());
+		}
+
+		return *this;
+	}
+
+	// Get operators
+	/////////////////////////////////
+
+	FORCEINLINE ObjectType& operator[](int64 idx) const { return _objects[idx]; }
+
+	// Validation
+	/////////////////////////////////
+
+	FORCEINLINE bool IsValid() const { return _objects != nullptr; }
+
+	// Getters
+	/////////////////////////////////
+
+	FORCEINLINE ObjectType* Get() const { return _objects; }
+
+	FORCEINLINE DeleterType& GetDeleter() { return DeleterStorageType::GetDeleter(); }
+	FORCEINLINE const DeleterType& GetDeleter() const { return DeleterStorageType::GetDeleter(); }
+
+	// Other
+	/////////////////////////////////
+
+	// Gives up ownership without deleting the objects
+	FORCEINLINE ObjectType* Release()
+	{
+		ObjectType* objects = _objects;
+		_objects = nullptr;
+		return objects;
+	}
+
+	// Deletes owned objects and takes ownership of the new ones
+	FORCEINLINE void Reset(ObjectType* objects = nullptr)
+	{
+		ObjectType* previous = _objects;
+		_objects = objects;
+
+		if (previous) GetDeleter()(previous);
+	}
+
+private:
+
+	ObjectType* _objects = nullptr;
+};
+
+// Owner is never stored inside the object, so moving bytes of the pointer is enough
+template<typename T, typename DeleterT>
+struct TIsBitwiseRelocatable<TUniquePtr<T, DeleterT>> { enum { Value = TIsBitwiseRelocatable<DeleterT>::Value }; };
+
+// Archive operator<< && operator>>
+////////////////////////////////////////////
+
+template<typename T, typename DeleterT>
+FORCEINLINE_DEBUGGABLE static SArchive& operator<<(SArchive& ar, const TUniquePtr<T, DeleterT>& uniquePtr)
+{
+	if (uniquePtr.IsValid())
+	{
+		ar << uniquePtr.GetRef();
+	}
+
+	return ar;
+}
+
+template<typename T, typename DeleterT>
+FORCEINLINE_DEBUGGABLE static SArchive& operator>>(SArchive& ar, TUniquePtr<T, DeleterT>& uniquePtr)
+{
+	if (uniquePtr.IsValid())
+	{
+		ar >> uniquePtr.GetRef();
+	}
+
+	return ar;
+}
+
+// Creates object owned by unique pointer
+template<typename T, typename... ArgTypes, typename TEnableIf<!TIsArray<T>::Value>::Type* = nullptr>
+FORCEINLINE_DEBUGGABLE static TUniquePtr<T> MakeUnique(ArgTypes&&... args)
+{
+	return TUniquePtr<T>(new T(Forward<ArgTypes>(args)...));
+}
+
+// Creates array of value initialized objects owned by unique pointer
+template<typename T, typename TEnableIf<TIsArray<T>::Value>::Type* = nullptr>
+FORCEINLINE_DEBUGGABLE static TUniquePtr<T> MakeUnique(int64 num)
+{
+	return TUniquePtr<T>(new typename TRemoveExtent<T>::Type[num]());
+}
@@ -0,0 +1,541 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTDMinimal.h"
+
+#include "ASTD/Archive.h"
+#include "ASTD/Array.h"
+#include "ASTD/Math.h"
+#include "ASTD/Memory.h"
+
+// Variable-length integer encoding (LEB128)
+// * Every byte stores 7 bits of the value, highest bit tells whether more bytes follow
+// * Signed values are zigzag encoded first, so small negative numbers stay short
+struct SVarInt
+{
+	static constexpr int32 MAX_BYTES_32 = 5;
+	static constexpr int32 MAX_BYTES_64 = 10;
+
+	// ZigZag
+	/////////////////////////////////
+
+	FORCEINLINE static uint32 ZigZagEncode(int32 value) { return ((uint32)value << 1) ^ (uint32)(value >> 31); }
+	FORCEINLINE static uint64 ZigZagEncode(int64 value) { return ((uint64)value << 1) ^ (uint64)(value >> 63); }
+
+	FORCEINLINE static int32 ZigZagDecode(uint32 value) { return (int32)(value >> 1) ^ -(int32)(value & 1); }
+	FORCEINLINE static int64 ZigZagDecode(uint64 value) { return (int64)(value >> 1) ^ -(int64)(value & 1); }
+
+	// Single value
+	/////////////////////////////////
+
+	// Gets number of bytes needed to encode value
+	FORCEINLINE static int32 GetEncodedSize(uint64 value) { return (int32)(SMath::FloorLog2(value | 1) / 7) + 1; }
+
+	// Encodes value into buffer with at least MAX_BYTES_64 bytes, returns number of bytes written
+	FORCEINLINE_DEBUGGABLE static int32 Encode(uint64 value, uint8* outBuffer)
+	{
+		int32 num = 0;
+		while (value >= 0x80)
+		{
+			outBuffer[num++] = (uint8)(value | 0x80);
+			value >>= 7;
+		}
+
+		outBuffer[num++] = (uint8)value;
+		return num;
+	}
+
+	// Decodes value from buffer, returns number of bytes read or 0 when buffer is truncated or malformed
+	FORCEINLINE_DEBUGGABLE static int32 Decode(const uint8* buffer, int64 size, uint64& outValue)
+	{
+		uint64 value = 0;
+
+		const int32 maxNum = (int32)SMath::Min<int64>(size, MAX_BYTES_64);
+		for (int32 i = 0; i < maxNum; ++i)
+		{
+			const uint8 byte = buffer[i];
+			value |= (uint64)(byte & 0x7F) << (7 * i);
+
+			if (!(byte & 0x80))
+			{
+				outValue = value;
+				return i + 1;
+			}
+		}
+
+		return 0;
+	}
+
+	// Arrays
+	// * Runs of small values (< 128) are processed 8 at a time through 64-bit words
+	/////////////////////////////////
+
+	// Encodes values and appends them to output, returns number of bytes appended
+	template<typename T, typename AllocatorT>
+	static int64 EncodeArray(const T* values, int64 num, TArray<uint8, AllocatorT>& outBytes)
+	{
+		static_assert(TIsIntegral<T>::Value, "Only integral types can be encoded");
+
+		const int64 startNum = outBytes.GetNum();
+		outBytes.AddUninitialized(num * MAX_BYTES_64);
+
+		uint8* const begin = outBytes.GetData() + startNum;
+		uint8* out = begin;
+
+		int64 i = 0;
+		while (i < num)
+		{
+			if (i + 8 <= num && AreSmallImpl(values + i))
+			{
+				for (int32 j = 0; j < 8; ++j)
+				{
+					out[j] = (uint8)ToUnsignedImpl(values[i + j]);
+				}
+
+				out += 8;
+				i += 8;
+			}
+			else
+			{
+				out += Encode(ToUnsignedImpl(values[i]), out);
+				++i;
+			}
+		}
+
+		const int64 written = out - begin;
+		outBytes.Resize(startNum + written);
+		return written;
+	}
+
+	// Decodes exactly "num" values, returns number of bytes read or 0 when buffer is truncated or malformed
+	template<typename T>
+	static int64 DecodeArray(const uint8* buffer, int64 size, T* outValues, int64 num)
+	{
+		static_assert(TIsIntegral<T>::Value, "Only integral types can be decoded");
+
+		int64 offset = 0;
+		int64 i = 0;
+		while (i < num)
+		{
+			uint64 word;
+			if (i + 8 <= num && offset + 8 <= size && (SMemory::Copy(&word, buffer + offset, 8), !(word & 0x8080808080808080ull)))
+			{
+				// 8 single byte values
+				for (int32 j = 0; j < 8; ++j)
+				{
+					outValues[i + j] = FromUnsignedImpl<T>(buffer[offset + j]);
+				}
+
+				offset += 8;
+				i += 8;
+			}
+			else
+			{
+				uint64 value;
+				const int32 read = Decode(buffer + offset, size - offset, value);
+				if (read == 0)
+				{
+					return 0;
+				}
+
+				outValues[i] = FromUnsignedImpl<T>(value);
+
+				offset += read;
+				++i;
+			}
+		}
+
+		return offset;
+	}
+
+	// Delta arrays
+	// * Meant for sorted (non-decreasing) values, every value is stored as difference to the previous one
+	// * Decreasing value fails the whole encoding, -1 is returned and nothing is appended
+	/////////////////////////////////
+
+	template<typename T, typename AllocatorT>
+	static int64 EncodeDeltaArray(const T* values, int64 num, TArray<uint8, AllocatorT>& outBytes)
+	{
+		static_assert(TIsIntegral<T>::Value, "Only integral types can be encoded");
+
+		constexpr int64 CHUNK_NUM = 256;
+		uint64 deltas[CHUNK_NUM];
+
+		const int64 startNum = outBytes.GetNum();
+
+		int64 written = 0;
+		uint64 previous = 0;
+		for (int64 i = 0; i < num; i += CHUNK_NUM)
+		{
+			const int64 chunkNum = SMath::Min(num - i, CHUNK_NUM);
+			for (int64 j = 0; j < chunkNum; ++j)
+			{
+				const uint64 value = (uint64)values[i + j];
+				if (!CHECK(i + j == 0 || values[i + j - 1] <= values[i + j]))
+				{
+					outBytes.Resize(startNum);
+					return -1;
+				}
+
+				deltas[j] = value - previous;
+				previous = value;
+			}
+
+			written += EncodeArray(deltas, chunkNum, outBytes);
+		}
+
+		return written;
+	}
+
+	template<typename T>
+	static int64 DecodeDeltaArray(const uint8* buffer, int64 size, T* outValues, int64 num)
+	{
+		static_assert(TIsIntegral<T>::Value, "Only integral types can be decoded");
+
+		constexpr int64 CHUNK_NUM = 256;
+		uint64 deltas[CHUNK_NUM];
+
+		int64 offset = 0;
+		uint64 previous = 0;
+		for (int64 i = 0; i < num; i += CHUNK_NUM)
+		{
+			const int64 chunkNum = SMath::Min(num - i, CHUNK_NUM);
+
+			const int64 read = DecodeArray(buffer + offset, size - offset, deltas, chunkNum);
+			if (read == 0)
+			{
+				return 0;
+			}
+
+			for (int64 j = 0; j < chunkNum; ++j)
+			{
+				previous += deltas[j];
+				outValues[i + j] = (T)previous;
+			}
+
+			offset += read;
+		}
+
+		return offset;
+	}
+
+	// Archive
+	/////////////////////////////////
+
+	FORCEINLINE_DEBUGGABLE static bool Write(SArchive& ar, uint64 value)
+	{
+		uint8 buffer[MAX_BYTES_64];
+		const int32 num = Encode(value, buffer);
+		return ar.WriteBytes(buffer, num) == num;
+	}
+
+	FORCEINLINE_DEBUGGABLE static bool WriteSigned(SArchive& ar, int64 value) { return Write(ar, ZigZagEncode(value)); }
+
+	// Reads value byte by byte, so archive is never moved past the encoded value
+	static bool Read(SArchive& ar, uint64& outValue)
+	{
+		uint64 value = 0;
+		for (int32 i = 0; i < MAX_BYTES_64; ++i)
+		{
+			uint8 byte;
+			if (ar.ReadBytes(&byte, 1) != 1)
+			{
+				return false;
+			}
+
+			value |= (uint64)(byte & 0x7F) << (7 * i);
+			if (!(byte & 0x80))
+			{
+				outValue = value;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	FORCEINLINE_DEBUGGABLE static bool ReadSigned(SArchive& ar, int64& outValue)
+	{
+		uint64 value;
+		if (!Read(ar, value)) return false;
+
+		outValue = ZigZagDecode(value);
+		return true;
+	}
+
+	// Writes array as [varint num][varint byte size][encoded values]
+	template<typename T, typename AllocatorT>
+	static bool WriteArray(SArchive& ar, const TArray<T, AllocatorT>& values, bool delta = false)
+	{
+		TArray<uint8> bytes;
+		if (delta)
+		{
+			// Unsorted values would produce stream ReadArray rejects
+			if (EncodeDeltaArray(values.GetData(), values.GetNum(), bytes) < 0) return false;
+		}
+		else
+		{
+			EncodeArray(values.GetData(), values.GetNum(), bytes);
+		}
+
+		return Write(ar, values.GetNum())
+			&& Write(ar, bytes.GetNum())
+			&& ar.WriteBytes(bytes.GetData(), bytes.GetNum()) == bytes.GetNum();
+	}
+
+	// Reads array written by WriteArray, "delta" has to match
+	template<typename T, typename AllocatorT>
+	static bool ReadArray(SArchive& ar, TArray<T, AllocatorT>& outValues, bool delta = false)
+	{
+		uint64 num, size;
+		if (!Read(ar, num) || !Read(ar, size))
+		{
+			return false;
+		}
+
+		// Every value takes at least one byte
+		if (num > size || size > (uint64)ar.GetRemainingOffset())
+		{
+			return false;
+		}
+
+		TArray<uint8> bytes;
+		bytes.AddUninitialized(size);
+		if (ar.ReadBytes(bytes.GetData(), size) != (SArchive::SizeType)size)
+		{
+			return false;
+		}
+
+		outValues.Empty(num);
+		outValues.AddUninitialized(num);
+
+		const int64 read = delta
+			? DecodeDeltaArray(bytes.GetData(), bytes.GetNum(), outValues.GetData(), num)
+			: DecodeArray(bytes.GetData(), bytes.GetNum(), outValues.GetData(), num);
+
+		return read == (int64)size || num == 0;
+	}
+
+private:
+
+	template<typename T>
+	FORCEINLINE static uint64 ToUnsignedImpl(T value)
+	{
+		if constexpr (TIsSigned<T>::Value) return ZigZagEncode((int64)value);
+		else return (uint64)value;
+	}
+
+	template<typename T>
+	FORCEINLINE static T FromUnsignedImpl(uint64 value)
+	{
+		if constexpr (TIsSigned<T>::Value) return (T)ZigZagDecode(value);
+		else return (T)value;
+	}
+
+	template<typename T>
+	FORCEINLINE static bool AreSmallImpl(const T* values)
+	{
+		uint64 combined = 0;
+		for (int32 i = 0; i < 8; ++i)
+		{
+			combined |= ToUnsignedImpl(values[i]);
+		}
+
+		return combined < 0x80;
+	}
+};
+
+// Bit-packed writer
+// * Values are appended LSB first into 64-bit accumulator that is moved into bytes once full
+template<typename AllocatorT = TArrayAllocator<uint8>>
+struct TBitWriter
+{
+	FORCEINLINE explicit TBitWriter(TArray<uint8, AllocatorT>& outBytes)
+		: _bytes(outBytes)
+	{}
+
+	FORCEINLINE ~TBitWriter() { Flush(); }
+
+	// Writes lowest "numBits" bits of value (max 57 bits per call)
+	FORCEINLINE void WriteBits(uint64 value, int32 numBits)
+	{
+		CHECK_RET(numBits >= 0 && numBits <= 57);
+
+		_accumulator |= (value & MaskImpl(numBits)) << _numBits;
+		_numBits += numBits;
+
+		while (_numBits >= 8)
+		{
+			_bytes.Add((uint8)_accumulator);
+			_accumulator >>= 8;
+			_numBits -= 8;
+		}
+	}
+
+	FORCEINLINE void WriteBool(bool value) { WriteBits(value ? 1 : 0, 1); }
+
+	// Writes pending bits padded with zeroes to the full byte
+	FORCEINLINE void Flush()
+	{
+		if (_numBits > 0)
+		{
+			_bytes.Add((uint8)_accumulator);
+			_accumulator = 0;
+			_numBits = 0;
+		}
+	}
+
+	FORCEINLINE static uint64 MaskImpl(int32 numBits) { return numBits >= 64 ? ~0ull : ((1ull << numBits) - 1); }
+
+private:
+
+	TArray<uint8, AllocatorT>& _bytes;
+	uint64 _accumulator = 0;
+	int32 _numBits = 0;
+};
+
+// Bit-packed reader for data written by TBitWriter
+struct SBitReader
+{
+	FORCEINLINE SBitReader(const uint8* data, int64 size)
+		: _data(data)
+		, _size(size)
+	{}
+
+	// Whether reader tried to read past the end of the data
+	FORCEINLINE bool HasOverflow() const { return _overflow; }
+
+	// Reads "numBits" bits (max 57 bits per call), missing bits are read as zeroes
+	FORCEINLINE uint64 ReadBits(int32 numBits)
+	{
+		CHECK_RET(numBits >= 0 && numBits <= 57, 0);
+
+		while (_numBits < numBits)
+		{
+			if (_offset < _size)
+			{
+				_accumulator |= (uint64)_data[_offset++] << _numBits;
+			}
+			else
+			{
+				_overflow = true;
+			}
+
+			_numBits += 8;
+		}
+
+		const uint64 value = _accumulator & ((1ull << numBits) - 1);
+		_accumulator >>= numBits;
+		_numBits -= numBits;
+
+		return value;
+	}
+
+	FORCEINLINE bool ReadBool() { return ReadBits(1) != 0; }
+
+private:
+
+	const uint8* _data;
+	int64 _size;
+	int64 _offset = 0;
+
+	uint64 _accumulator = 0;
+	int32 _numBits = 0;
+	bool _overflow = false;
+};
+
+// Fixed width bit packing of whole arrays
+struct SBitPacker
+{
+	// Gets number of bits needed to store biggest of the values
+	template<typename T>
+	static int32 GetRequiredBits(const T* values, int64 num)
+	{
+		uint64 combined = 0;
+		for (int64 i = 0; i < num; ++i)
+		{
+			combined |= (uint64)values[i];
+		}
+
+		return combined == 0 ? 0 : (int32)SMath::FloorLog2(combined) + 1;
+	}
+
+	// Gets number of bytes needed to store "num" values of "bitWidth" bits
+	FORCEINLINE static int64 GetPackedSize(int64 num, int32 bitWidth) { return (num * bitWidth + 7) / 8; }
+
+	// Packs values with "bitWidth" bits each (max 57) and appends them to output
+	template<typename T, typename AllocatorT>
+	static void Pack(const T* values, int64 num, int32 bitWidth, TArray<uint8, AllocatorT>& outBytes)
+	{
+		static_assert(TIsIntegral<T>::Value, "Only integral types can be packed");
+		CHECK_RET(bitWidth >= 0 && bitWidth <= 57);
+
+		if (bitWidth > 32)
+		{
+			// Wide values would not fit into accumulator next to pending bits
+			TBitWriter<AllocatorT> writer(outBytes);
+			for (int64 i = 0; i < num; ++i)
+			{
+				writer.WriteBits((uint64)values[i], bitWidth);
+			}
+
+			return;
+		}
+
+		const int64 startNum = outBytes.GetNum();
+		const int64 packedSize = GetPackedSize(num, bitWidth);
+		outBytes.AddUninitialized(packedSize);
+
+		uint8* out = outBytes.GetData() + startNum;
+		const uint64 mask = TBitWriter<AllocatorT>::MaskImpl(bitWidth);
+
+		uint64 accumulator = 0;
+		int32 numBits = 0;
+		int64 offset = 0;
+		for (int64 i = 0; i < num; ++i)
+		{
+			accumulator |= ((uint64)values[i] & mask) << numBits;
+			numBits += bitWidth;
+
+			if (numBits >= 32)
+			{
+				// Moves whole 32-bit word at once
+				const uint32 word = (uint32)accumulator;
+				SMemory::Copy(out + offset, &word, 4);
+
+				offset += 4;
+				accumulator >>= 32;
+				numBits -= 32;
+			}
+		}
+
+		while (numBits > 0)
+		{
+			out[offset++] = (uint8)accumulator;
+			accumulator >>= 8;
+			numBits -= 8;
+		}
+	}
+
+	// Unpacks "num" values, returns false when data is too short
+	template<typename T>
+	static bool Unpack(const uint8* data, int64 size, int32 bitWidth, T* outValues, int64 num)
+	{
+		static_assert(TIsIntegral<T>::Value, "Only integral types can be unpacked");
+		CHECK_RET(bitWidth >= 0 && bitWidth <= 57, false);
+
+		if (GetPackedSize(num, bitWidth) > size)
+		{
+			return false;
+		}
+
+		SBitReader reader(data, size);
+		for (int64 i = 0; i < num; ++i)
+		{
+			outValues[i] = (T)reader.ReadBits(bitWidth);
+		}
+
+		return true;
+	}
+};
@@ -0,0 +1,196 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include <cstdio>
+#include <io.h>
+
+#include "ASTD/Win32/WindowsBuild.h"
+#include "ASTD/_internal/FileTypes.h"
+
+struct SWindowsPlatformFile
+{
+	typedef HANDLE HandleType;
+
+	static constexpr int32 MAX_SLICES = 16;
+
+	static inline const HandleType INVALID_HANDLE = INVALID_HANDLE_VALUE;
+
+	// Opens file, returns INVALID_HANDLE on failure
+	static HandleType Open(const tchar* filename, uint32 flags)
+	{
+		DWORD access = 0;
+		if (flags & EFileOpenFlags::Read) access |= GENERIC_READ;
+		if (flags & EFileOpenFlags::Write) access |= GENERIC_WRITE;
+
+		const bool create = flags & EFileOpenFlags::Create;
+		const bool truncate = flags & EFileOpenFlags::Truncate;
+
+		const DWORD disposition = create
+			? (truncate ? CREATE_ALWAYS : OPEN_ALWAYS)
+			: (truncate ? TRUNCATE_EXISTING : OPEN_EXISTING);
+
+		DWORD attributes = FILE_ATTRIBUTE_NORMAL;
+		if (flags & EFileOpenFlags::Direct) attributes |= FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH;
+
+		return CreateFile(filename, access, FILE_SHARE_READ, nullptr, disposition, attributes, nullptr);
+	}
+
+	// Closes file
+	FORCEINLINE static void Close(HandleType handle) { CloseHandle(handle); }
+
+	// Gets handle used by C stream, stream has to be flushed before handle is used directly
+	FORCEINLINE static HandleType GetStreamHandle(FILE* stream) { return stream ? (HandleType)_get_osfhandle(_fileno(stream)) : INVALID_HANDLE; }
+
+	// Gets size of the file in bytes, -1 on failure
+	static int64 GetSize(HandleType handle)
+	{
+		LARGE_INTEGER size;
+		return GetFileSizeEx(handle, &size) ? size.QuadPart : -1;
+	}
+
+	// Changes size of the file
+	static bool Truncate(HandleType handle, int64 size)
+	{
+		FILE_END_OF_FILE_INFO info;
+		info.EndOfFile.QuadPart = size;
+		return SetFileInformationByHandle(handle, FileEndOfFileInfo, &info, sizeof(info));
+	}
+
+	// Reads bytes from specific offset, does not move file position
+	static int64 ReadAt(HandleType handle, void* buffer, int64 size, int64 offset)
+	{
+		OVERLAPPED overlapped = MakeOverlappedImpl(offset);
+
+		DWORD readBytes = 0;
+		if (!ReadFile(handle, buffer, (DWORD)size, &readBytes, &overlapped))
+		{
+			return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+		}
+
+		return readBytes;
+	}
+
+	// Writes bytes to specific offset, does not move file position
+	static int64 WriteAt(HandleType handle, const void* buffer, int64 size, int64 offset)
+	{
+		OVERLAPPED overlapped = MakeOverlappedImpl(offset);
+
+		DWORD writtenBytes = 0;
+		return WriteFile(handle, buffer, (DWORD)size, &writtenBytes, &overlapped) ? (int64)writtenBytes : -1;
+	}
+
+	// Reads bytes from specific offset into multiple blocks
+	// * Windows has no vectored variant for buffered handles, so slices are processed one by one
+	static int64 ReadVectoredAt(HandleType handle, const SFileSlice* slices, int32 num, int64 offset)
+	{
+		int64 total = 0;
+		for (int32 i = 0; i < num; ++i)
+		{
+			const int64 result = ReadAt(handle, slices[i].Data, slices[i].Size, offset + total);
+			if (result < 0) return total > 0 ? total : result;
+
+			total += result;
+			if (result < slices[i].Size) break;
+		}
+
+		return total;
+	}
+
+	// Writes bytes to specific offset from multiple blocks
+	// * Windows has no vectored variant for buffered handles, so slices are processed one by one
+	static int64 WriteVectoredAt(HandleType handle, const SFileSlice* slices, int32 num, int64 offset)
+	{
+		int64 total = 0;
+		for (int32 i = 0; i < num; ++i)
+		{
+			const int64 result = WriteAt(handle, slices[i].Data, slices[i].Size, offset + total);
+			if (result < 0) return total > 0 ? total : result;
+
+			total += result;
+			if (result < slices[i].Size) break;
+		}
+
+		return total;
+	}
+
+	// Flushes data and metadata of the file to the storage device
+	FORCEINLINE static bool Sync(HandleType handle) { return FlushFileBuffers(handle); }
+
+	// Flushes data of the file to the storage device
+	FORCEINLINE static bool DataSync(HandleType handle) { return FlushFileBuffers(handle); }
+
+	// Copies bytes between two handles inside the kernel
+	// * Not supported, CopyFileEx works with whole files only
+	FORCEINLINE static int64 CopyRange(HandleType, int64, HandleType, int64, int64) { return -1; }
+
+	// Maps first "size" bytes of the file into memory
+	static bool Map(HandleType handle, int64 size, bool writable, SFileMapping& outMapping)
+	{
+		HANDLE mappingHandle = CreateFileMapping(
+			handle, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+			(DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFF), nullptr
+		);
+
+		if (!mappingHandle)
+		{
+			return false;
+		}
+
+		void* data = MapViewOfFile(mappingHandle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, (SIZE_T)size);
+		if (!data)
+		{
+			CloseHandle(mappingHandle);
+			return false;
+		}
+
+		outMapping.Data = (uint8*)data;
+		outMapping.Size = size;
+		outMapping.Native = mappingHandle;
+		outMapping.File = handle;
+		return true;
+	}
+
+	// Unmaps previously mapped region
+	static void Unmap(SFileMapping& mapping)
+	{
+		if (mapping.Data)
+		{
+			UnmapViewOfFile(mapping.Data);
+		}
+
+		if (mapping.Native)
+		{
+			CloseHandle((HANDLE)mapping.Native);
+		}
+
+		mapping = SFileMapping();
+	}
+
+	// Writes modified pages of the mapped region back to the file
+	// * FlushViewOfFile only queues the writes, waiting flushes the file buffers as well (like msync with MS_SYNC)
+	static bool FlushMapping(const SFileMapping& mapping, bool wait)
+	{
+		if (!mapping.Data)
+		{
+			return true;
+		}
+
+		if (!FlushViewOfFile(mapping.Data, (SIZE_T)mapping.Size))
+		{
+			return false;
+		}
+
+		return !wait || FlushFileBuffers((HANDLE)mapping.File);
+	}
+
+private:
+
+	FORCEINLINE static OVERLAPPED MakeOverlappedImpl(int64 offset)
+	{
+		OVERLAPPED overlapped = {};
+		overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+		overlapped.OffsetHigh = (DWORD)(offset >> 32);
+		return overlapped;
+	}
+};
@@ -4,6 +4,8 @@
 
 #include "ASTD/Win32/WindowsBuild.h"
 
+#include <malloc.h>
+
 // TODO(jan.kristian.fisera): Virtual memory allocations
 // * see: https://docs.microsoft.com/en-us/windows/win32/api/memoryapi/nf-memoryapi-virtualalloc
 struct SWindowsPlatformMemory
@@ -20,6 +22,15 @@ struct SWindowsPlatformMemory
 	// Deallocates memory
 	FORCEINLINE static void Free(void* ptr) { HeapFree(GetProcessHeap(), 0, ptr); }
 
+	// Allocates new memory aligned to "alignment" (power of two), has to be freed by FreeAligned
+	FORCEINLINE static void* MallocAligned(int64 size, int64 alignment) { return _aligned_malloc(size, alignment); }
+
+	// Reallocates aligned memory
+	FORCEINLINE static void* ReallocAligned(void* ptr, int64 size, int64 alignment) { return _aligned_realloc(ptr, size, alignment); }
+
+	// Deallocates memory allocated by MallocAligned
+	FORCEINLINE static void FreeAligned(void* ptr) { _aligned_free(ptr); }
+
 	// Copies block of memory from destionation to source (does not handle overlapping)
 	FORCEINLINE static void* Copy(void* dest, const void* src, int64 size) { return CopyMemory(dest, src, size); }
 
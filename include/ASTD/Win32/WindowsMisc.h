@@ -7,6 +7,7 @@
 
 struct SWindowsPlatformMisc
 {
+	// Gets wall clock time in seconds since epoch, see STime for precise integer clocks
 	static double GetSecondsSinceEpoch()
 	{
 		int64 wintime;
@@ -16,8 +17,30 @@ struct SWindowsPlatformMisc
 	}
 
 	// Reads from standard file by fileno. example: STDIN_FILENO
-	static int64 ReadFromFile(int32 fileNo, void* buffer, uint64 size) { return _read(fileNo, buffer, size); }
+	static int64 ReadStd(int32 fileNo, void* buffer, uint64 size) { return _read(fileNo, buffer, size); }
 
 	// Writes to standard file by fileno. example: STDOUT_FILENO
-	static int64 WriteToFile(int32 fileNo, const void* buffer, uint64 size) { return _write(fileNo, buffer, size); }
+	static int64 WriteStd(int32 fileNo, const void* buffer, uint64 size) { return _write(fileNo, buffer, size); }
+
+	// Writes multiple buffers to standard file by fileno at once
+	// * Returns number of written bytes or -1 on error
+	static int64 WriteStdBuffers(int32 fileNo, const void* const* buffers, const uint64* sizes, int32 num)
+	{
+		// No vectored write for CRT file descriptors, buffers are written one by one
+		int64 totalWritten = 0;
+		for (int32 i = 0; i < num; ++i)
+		{
+			uint64 offset = 0;
+			while (offset < sizes[i])
+			{
+				const int written = _write(fileNo, (const uint8*)buffers[i] + offset, (unsigned int)(sizes[i] - offset));
+				if (written < 0) return -1;
+
+				offset += written;
+				totalWritten += written;
+			}
+		}
+
+		return totalWritten;
+	}
 };
@@ -0,0 +1,39 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTD/Win32/WindowsBuild.h"
+
+struct SWindowsPlatformTime
+{
+	// Gets monotonic time in nanoseconds, starting point is unspecified
+	static int64 GetMonotonicNanoseconds()
+	{
+		static const int64 frequency = []() { LARGE_INTEGER value; QueryPerformanceFrequency(&value); return (int64)value.QuadPart; }();
+
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter(&counter);
+
+		// Split, so multiplication does not overflow
+		return (counter.QuadPart / frequency) * 1000000000 + (counter.QuadPart % frequency) * 1000000000 / frequency;
+	}
+
+	// Gets monotonic time in nanoseconds, cheap but with precision of few milliseconds
+	FORCEINLINE static int64 GetCoarseMonotonicNanoseconds() { return (int64)GetTickCount64() * 1000000; }
+
+	// Gets wall clock time in nanoseconds since epoch
+	FORCEINLINE static int64 GetWallNanoseconds()
+	{
+		int64 wintime;
+		GetSystemTimePreciseAsFileTime((FILETIME*)&wintime);
+		return (wintime - 116444736000000000i64) * 100;
+	}
+
+	// Gets wall clock time in nanoseconds since epoch, cheap but with precision of few milliseconds
+	FORCEINLINE static int64 GetCoarseWallNanoseconds()
+	{
+		int64 wintime;
+		GetSystemTimeAsFileTime((FILETIME*)&wintime);
+		return (wintime - 116444736000000000i64) * 100;
+	}
+};
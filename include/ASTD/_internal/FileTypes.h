@@ -0,0 +1,65 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+#include "ASTD/Build.h"
+
+// Flags used when opening platform file
+// * Can be combined, example: EFileOpenFlags::Read | EFileOpenFlags::Write
+namespace EFileOpenFlags
+{
+	enum Type : uint32
+	{
+		None = 0,
+
+		Read = 1 << 0,
+		Write = 1 << 1,
+
+		// Creates file when it does not exist
+		Create = 1 << 2,
+
+		// Discards previous content of the file
+		Truncate = 1 << 3,
+
+		// Bypasses OS page cache (O_DIRECT)
+		// * Buffers, sizes and offsets have to be aligned to storage block size
+		Direct = 1 << 4
+	};
+}
+
+// Single memory block used by vectored (scatter/gather) operations
+struct SFileSlice
+{
+	void* Data;
+	int64 Size;
+};
+
+// Region of the file mapped into memory
+struct SFileMapping
+{
+	uint8* Data = nullptr;
+	int64 Size = 0;
+
+	// Platform specific mapping object (if any)
+	void* Native = nullptr;
+
+	// Handle of mapped file, when platform needs it to flush the mapping
+	void* File = nullptr;
+};
+
+// Operation processed by asynchronous file queue
+enum class EAsyncFileOp : uint8
+{
+	Read = 0,
+	Write
+};
+
+// Completion reported by asynchronous file queue
+struct SAsyncFileCompletion
+{
+	// Value provided when operation was queued
+	uint64 UserData;
+
+	// Number of processed bytes or negative error code
+	int64 Result;
+};
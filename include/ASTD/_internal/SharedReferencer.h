@@ -4,73 +4,257 @@
 
 #include "ASTD/Build.h"
 #include "ASTD/Check.h"
+#include "ASTD/Memory.h"
 
 // TODO(jkfisera): REIMPLEMENT Invoke
+#include <functional>
 #include <type_traits>
 
+// TODO: Replace with custom implementation
+#include <atomic>
+#include <cstddef>
+
 namespace _NShared
 {
 	struct SNullType {};
 
-	class CReferencerBase
+	// Default allocator of referencers that hold the object inline
+	// * Custom allocators (pools) have to provide the same methods, they are copied into every referencer
+	struct SReferencerAllocator
 	{
-	public:
-		virtual ~CReferencerBase() = default;
+		FORCEINLINE void* Allocate(int64 size) { return SMemory::Malloc(size); }
+		FORCEINLINE void Free(void* ptr, int64) { SMemory::Free(ptr); }
+	};
 
-		// Getters
-		/////////////////////////////////
+	// Default allocator of referencers that hold over-aligned object inline
+	template<int64 Alignment>
+	struct TAlignedReferencerAllocator
+	{
+		FORCEINLINE void* Allocate(int64 size) { return SMemory::MallocAligned(size, Alignment); }
+		FORCEINLINE void Free(void* ptr, int64) { SMemory::FreeAligned(ptr); }
+	};
 
-		FORCEINLINE bool HasAnyReference() const { return _sharedNum + _weakCount > 0; }
-		FORCEINLINE uint16 GetSharedNum() const { return _sharedNum; }
-		FORCEINLINE uint16 GetWeakCount() const { return _weakCount; }
+	// Reference count selected by shared pointer mode
+	template<ESPMode Mode>
+	struct TReferenceCount;
 
-		template<typename T>
-		FORCEINLINE T* GetObject() const { return reinterpret_cast<T*>(GetObjectImpl()); }
+	template<>
+	struct TReferenceCount<ESPMode::NotThreadSafe>
+	{
+		FORCEINLINE explicit TReferenceCount(int32 value) : _value(value) {}
 
-		FORCEINLINE bool HasObject() const { return GetObjectImpl() != nullptr; }
+		FORCEINLINE int32 Get() const { return _value; }
 
-		// Setters [Add]
-		/////////////////////////////////
+		FORCEINLINE void Increment() { ++_value; }
 
-		FORCEINLINE void AddShared()
+		// Increments only when there is still some reference
+		FORCEINLINE bool IncrementIfNotZero()
 		{
-			CHECK_RET(_sharedNum < UINT16_MAX);
-			++_sharedNum;
+			if (_value == 0) return false;
+
+			++_value;
+			return true;
 		}
 
-		FORCEINLINE void AddWeak()
+		// Returns true once the last reference is removed
+		FORCEINLINE bool Decrement()
+		{
+#if ASTD_DO_CHECKS
+			CHECK(_value > 0); // underflow
+#endif
+			return --_value == 0;
+		}
+
+	private:
+
+		int32 _value;
+	};
+
+	template<>
+	struct TReferenceCount<ESPMode::ThreadSafe>
+	{
+		FORCEINLINE explicit TReferenceCount(int32 value) : _value(value) {}
+
+		FORCEINLINE int32 Get() const { return _value.load(std::memory_order_relaxed); }
+
+		// New reference is always made from existing one, so nothing has to be ordered
+		FORCEINLINE void Increment() { _value.fetch_add(1, std::memory_order_relaxed); }
+
+		FORCEINLINE bool IncrementIfNotZero()
+		{
+			int32 value = _value.load(std::memory_order_relaxed);
+			do
+			{
+				if (value == 0) return false;
+			}
+			while (!_value.compare_exchange_weak(value, value + 1, std::memory_order_relaxed));
+
+			return true;
+		}
+
+		// Release makes all uses of the object visible to the thread that destroys it
+		FORCEINLINE bool Decrement()
 		{
-			CHECK_RET(_weakCount < UINT16_MAX); // overflow
-			++_weakCount;
+			const int32 previous = _value.fetch_sub(1, std::memory_order_release);
+#if ASTD_DO_CHECKS
+			CHECK(previous > 0); // underflow
+#endif
+
+			if (previous == 1)
+			{
+				std::atomic_thread_fence(std::memory_order_acquire);
+				return true;
+			}
+
+			return false;
 		}
 
+	private:
+
+		std::atomic<int32> _value;
+	};
+
+	// Operation requested from referencer once its counts drop to zero
+	enum class EReferencerOp : uint8
+	{
+		DestructObject = 0,
+		DestroyReferencer
+	};
+
+	// Owns reference counts of single object
+	// * All shared references together hold one weak reference, so referencer is deleted only once the object is gone
+	// * Not virtual, typed part is reached through single operation function (16 bytes on 64-bit)
+	// * Null operation means object has nothing to destruct and referencer memory is owned by SMemory
+	template<ESPMode Mode>
+	class TReferencerBase
+	{
+	public:
+		typedef void (*OperationFuncType)(TReferencerBase*, EReferencerOp);
+
+		FORCEINLINE explicit TReferencerBase(OperationFuncType operation)
+			: _operation(operation)
+		{}
+
+		TReferencerBase(const TReferencerBase&) = delete;
+		TReferencerBase& operator=(const TReferencerBase&) = delete;
+
+		// Getters
+		/////////////////////////////////
+
+		FORCEINLINE int32 GetSharedNum() const { return _sharedNum.Get(); }
+		FORCEINLINE int32 GetWeakNum() const { return _weakNum.Get() - (_sharedNum.Get() > 0 ? 1 : 0); }
+
+		// Setters [Add]
+		/////////////////////////////////
+
+		FORCEINLINE void AddShared() { _sharedNum.Increment(); }
+		FORCEINLINE void AddWeak() { _weakNum.Increment(); }
+
+		// Adds shared reference only when object is still alive, used to pin weak references
+		FORCEINLINE bool TryAddShared() { return _sharedNum.IncrementIfNotZero(); }
+
 		// Setters [REMOVE]
 		/////////////////////////////////
 
+		// Referencer may be deleted once this returns
 		FORCEINLINE void RemoveShared()
 		{
-			CHECK_RET(_sharedNum > 0); // underflow
-			if(_sharedNum == 1) DeconstructObjectImpl();
-			--_sharedNum;
+			if (_sharedNum.Decrement())
+			{
+				if (_operation)
+				{
+					_operation(this, EReferencerOp::DestructObject);
+				}
+
+				RemoveWeak();
+			}
 		}
 
+		// Referencer may be deleted once this returns
 		FORCEINLINE void RemoveWeak()
 		{
-			CHECK_RET(_weakCount > 0); // underflow
-			--_weakCount;
+			if (_weakNum.Decrement())
+			{
+				if (_operation)
+				{
+					_operation(this, EReferencerOp::DestroyReferencer);
+				}
+				else
+				{
+					SMemory::Free(this);
+				}
+			}
 		}
 
-	protected:
+	private:
 
-		virtual void* GetObjectImpl() const = 0;
-		virtual void DeconstructObjectImpl() = 0;
+		TReferenceCount<Mode> _sharedNum = TReferenceCount<Mode>(0);
+		TReferenceCount<Mode> _weakNum = TReferenceCount<Mode>(1);
+		OperationFuncType _operation;
+	};
+
+	static_assert(sizeof(TReferencerBase<ESPMode::ThreadSafe>) <= 16, "Referencer should fit into 16 bytes");
+	static_assert(sizeof(TReferencerBase<ESPMode::NotThreadSafe>) <= 16, "Referencer should fit into 16 bytes");
+
+	// Referencer of object released by "delete"
+	template<typename T, ESPMode Mode>
+	class TDefaultReferencer : public TReferencerBase<Mode>
+	{
+	public:
+		typedef T ObjectType;
+
+		FORCEINLINE explicit TDefaultReferencer(ObjectType* object)
+			: TReferencerBase<Mode>(&OperationImpl)
+			, _object(object)
+		{}
 
-		uint16 _sharedNum = 0;
-		uint16 _weakCount = 0;
+	private:
+
+		static void OperationImpl(TReferencerBase<Mode>* base, EReferencerOp op)
+		{
+			TDefaultReferencer* referencer = static_cast<TDefaultReferencer*>(base);
+			if (op == EReferencerOp::DestructObject)
+			{
+				delete referencer->_object;
+				referencer->_object = nullptr;
+			}
+			else
+			{
+				SMemory::Free(referencer);
+			}
+		}
+
+		ObjectType* _object;
 	};
 
-	template<typename T, typename DeleterT>
-	class TCustomReferencer : public CReferencerBase
+	// Holds deleter, empty deleters take no space
+	template<typename DeleterT, bool IsEmpty = TIsEmptyType<DeleterT>::Value>
+	struct TDeleterStorage : private DeleterT
+	{
+		template<typename OtherDeleterT>
+		FORCEINLINE explicit TDeleterStorage(OtherDeleterT&& deleter) : DeleterT(Forward<OtherDeleterT>(deleter)) {}
+
+		FORCEINLINE DeleterT& GetDeleter() { return *this; }
+		FORCEINLINE const DeleterT& GetDeleter() const { return *this; }
+	};
+
+	template<typename DeleterT>
+	struct TDeleterStorage<DeleterT, false>
+	{
+		template<typename OtherDeleterT>
+		FORCEINLINE explicit TDeleterStorage(OtherDeleterT&& deleter) : _deleter(Forward<OtherDeleterT>(deleter)) {}
+
+		FORCEINLINE DeleterT& GetDeleter() { return _deleter; }
+		FORCEINLINE const DeleterT& GetDeleter() const { return _deleter; }
+
+	private:
+
+		DeleterT _deleter;
+	};
+
+	// Referencer of object released by custom deleter
+	template<typename T, typename DeleterT, ESPMode Mode>
+	class TCustomReferencer : public TReferencerBase<Mode>, private TDeleterStorage<DeleterT>
 	{
 	public:
 		// Typedefs
@@ -86,83 +270,151 @@ namespace _NShared
 
 		template<typename OtherDeleterT>
 		FORCEINLINE TCustomReferencer(ObjectType* object, OtherDeleterT&& deleter)
-			: CReferencerBase()
+			: TReferencerBase<Mode>(&OperationImpl)
+			, TDeleterStorage<DeleterT>(Forward<OtherDeleterT>(deleter))
 			, _object(object)
-			, _deleter(MoveIfPossible(deleter))
 		{}
 
-		virtual ~TCustomReferencer() override {	DestructObjectImpl(); }
-
-	protected:
-
-		// ~BEGIN CReferencerBase interface
-		FORCEINLINE virtual void* GetObjectImpl() const override { return _object; }
-		FORCEINLINE virtual void DeconstructObjectImpl() override { DestructObjectImpl(); }
-		// ~END CReferencerBase interface
+	private:
 
-	private: // Fields
-		void DestructObjectImpl()
+		static void OperationImpl(TReferencerBase<Mode>* base, EReferencerOp op)
 		{
-			if(_object)
+			TCustomReferencer* referencer = static_cast<TCustomReferencer*>(base);
+			if (op == EReferencerOp::DestructObject)
 			{
-				std::invoke(_deleter, _object);
-				_object = nullptr;
+				if (referencer->_object)
+				{
+					std::invoke(referencer->GetDeleter(), referencer->_object);
+					referencer->_object = nullptr;
+				}
+			}
+			else
+			{
+				referencer->~TCustomReferencer();
+				SMemory::Free(referencer);
 			}
 		}
 
 		ObjectType* _object;
-		DeleterType _deleter;
 	};
 
-	template<typename ObjectT>
-	void DefaultDeleteObjectFunc(ObjectT* obj)
+	// Referencer with object constructed inside of it, so both are created with single allocation
+	template<typename T, typename AllocatorT, ESPMode Mode>
+	class TInlineReferencer : public TReferencerBase<Mode>, private AllocatorT
 	{
-		delete obj;
-	}
+	public:
+		// Typedefs
+		/////////////////////////////////
+
+		typedef T ObjectType;
+		typedef AllocatorT AllocatorType;
+
+		// Constructors
+		/////////////////////////////////
+
+		template<typename... ArgTypes>
+		FORCEINLINE TInlineReferencer(const AllocatorType& allocator, ArgTypes&&... args)
+			: TReferencerBase<Mode>(GetOperationImpl())
+			, AllocatorType(allocator)
+		{
+			::new((void*)_storage) ObjectType(Forward<ArgTypes>(args)...);
+		}
+
+		FORCEINLINE ObjectType* GetObject() { return (ObjectType*)_storage; }
+
+	private:
+
+		// Default allocator with trivially destructible object needs no operation at all
+		FORCEINLINE static constexpr typename TReferencerBase<Mode>::OperationFuncType GetOperationImpl()
+		{
+			if constexpr (TIsSame<AllocatorType, SReferencerAllocator>::Value && TIsTriviallyDestructible<ObjectType>::Value)
+			{
+				return nullptr;
+			}
+			else
+			{
+				return &OperationImpl;
+			}
+		}
 
-	template<typename ObjectType, typename DeleterType>
-	FORCEINLINE static CReferencerBase* NewCustomReferencerWithDeleter(ObjectType* obj, DeleterType&& deleter)
+		static void OperationImpl(TReferencerBase<Mode>* base, EReferencerOp op)
+		{
+			TInlineReferencer* referencer = static_cast<TInlineReferencer*>(base);
+			if (op == EReferencerOp::DestructObject)
+			{
+				SMemory::Destruct(referencer->GetObject());
+			}
+			else
+			{
+				// Allocator has to survive destruction of the referencer that owns it
+				AllocatorType allocator = Move(static_cast<AllocatorType&>(*referencer));
+
+				referencer->~TInlineReferencer();
+				allocator.Free(referencer, sizeof(TInlineReferencer));
+			}
+		}
+
+		alignas(ObjectType) uint8 _storage[sizeof(ObjectType)];
+	};
+
+	template<typename ObjectType, ESPMode Mode, typename DeleterType>
+	FORCEINLINE static TReferencerBase<Mode>* NewCustomReferencerWithDeleter(ObjectType* obj, DeleterType&& deleter)
 	{
-		return new TCustomReferencer<ObjectType, DeleterType>(obj, MoveIfPossible(deleter));
+		typedef TCustomReferencer<ObjectType, typename TDecay<DeleterType>::Type, Mode> ReferencerType;
+		return ::new(SMemory::Malloc(sizeof(ReferencerType))) ReferencerType(obj, Forward<DeleterType>(deleter));
 	}
 
-	template<typename ObjectType>
-	FORCEINLINE_DEBUGGABLE static CReferencerBase* NewCustomReferencer(ObjectType* obj)
+	template<typename ObjectType, ESPMode Mode>
+	FORCEINLINE_DEBUGGABLE static TReferencerBase<Mode>* NewCustomReferencer(ObjectType* obj)
 	{
-		return NewCustomReferencerWithDeleter(obj, &DefaultDeleteObjectFunc<ObjectType>);
+		typedef TDefaultReferencer<ObjectType, Mode> ReferencerType;
+		return ::new(SMemory::Malloc(sizeof(ReferencerType))) ReferencerType(obj);
 	}
 
-	FORCEINLINE static void DeleteReferencer(CReferencerBase* referencer)
+	template<typename ObjectType, ESPMode Mode, typename AllocatorType, typename... ArgTypes>
+	FORCEINLINE_DEBUGGABLE static TInlineReferencer<ObjectType, AllocatorType, Mode>* NewInlineReferencer(const AllocatorType& allocator, ArgTypes&&... args)
 	{
-		delete referencer;
+		typedef TInlineReferencer<ObjectType, AllocatorType, Mode> ReferencerType;
+		static_assert(
+			alignof(ReferencerType) <= alignof(std::max_align_t) || TIsSame<AllocatorType, TAlignedReferencerAllocator<alignof(ReferencerType)>>::Value,
+			"Over-aligned objects are not supported by custom referencer allocators"
+		);
+
+		void* memory = AllocatorType(allocator).Allocate(sizeof(ReferencerType));
+		CHECK_RET(memory, nullptr);
+
+		return ::new(memory) ReferencerType(allocator, Forward<ArgTypes>(args)...);
 	}
 
 	// Contains helper methods for referencer
 	// * Should be used internally
 	// * Handles even deconstruction of referencer
-	struct SReferencerProxy
+	template<ESPMode Mode>
+	struct TReferencerProxy
 	{
+		typedef TReferencerBase<Mode> ReferencerType;
+
 		// Constructors
 		/////////////////////////////////
 
-		FORCEINLINE SReferencerProxy(CReferencerBase* InReferencer)
+		FORCEINLINE TReferencerProxy(ReferencerType* InReferencer)
 			: _inner(InReferencer)
 		{}
 
 		// Compare operators
 		/////////////////////////////////
 
-		FORCEINLINE bool operator==(const SReferencerProxy& other) const { return _inner == other._inner; }
-		FORCEINLINE bool operator!=(const SReferencerProxy& other) const { return !operator==(other); }
+		FORCEINLINE bool operator==(const TReferencerProxy& other) const { return _inner == other._inner; }
+		FORCEINLINE bool operator!=(const TReferencerProxy& other) const { return !operator==(other); }
 
 		// Pointer operators
 		/////////////////////////////////
 
-		FORCEINLINE CReferencerBase* operator->() { return Get(); }
-		FORCEINLINE const CReferencerBase* operator->() const { return Get(); }
+		FORCEINLINE ReferencerType* operator->() { return Get(); }
+		FORCEINLINE const ReferencerType* operator->() const { return Get(); }
 
-		FORCEINLINE CReferencerBase& operator*() { return *Get(); }
-		FORCEINLINE const CReferencerBase& operator*() const { return *Get(); }
+		FORCEINLINE ReferencerType& operator*() { return *Get(); }
+		FORCEINLINE const ReferencerType& operator*() const { return *Get(); }
 
 		// Checkers
 		/////////////////////////////////
@@ -174,12 +426,12 @@ namespace _NShared
 		// Getters
 		/////////////////////////////////
 
-		FORCEINLINE CReferencerBase* Get() const { return _inner; }
+		FORCEINLINE ReferencerType* Get() const { return _inner; }
 
 		// Setters
 		/////////////////////////////////
 
-		FORCEINLINE void Set(CReferencerBase* referencer) { _inner = referencer; }
+		FORCEINLINE void Set(ReferencerType* referencer) { _inner = referencer; }
 
 		// Helper methods [Add]
 		/////////////////////////////////
@@ -198,6 +450,11 @@ namespace _NShared
 			_inner->AddWeak();
 		}
 
+		FORCEINLINE bool TryAddShared()
+		{
+			return IsValid() && _inner->TryAddShared();
+		}
+
 		// Helper methods [Remove]
 		/////////////////////////////////
 
@@ -206,11 +463,7 @@ namespace _NShared
 			if(!IsValid()) return;
 
 			_inner->RemoveShared();
-			if(!_inner->HasAnyReference())
-			{
-				DeleteReferencer(_inner);
-				_inner = nullptr;
-			}
+			_inner = nullptr;
 		}
 
 		FORCEINLINE void RemoveWeak()
@@ -218,15 +471,11 @@ namespace _NShared
 			if(!IsValid()) return;
 
 			_inner->RemoveWeak();
-			if (!_inner->HasAnyReference()) 
-			{
-				DeleteReferencer(_inner);
-				_inner = nullptr;
-			}
+			_inner = nullptr;
 		}
 
 	private:
 
-		CReferencerBase* _inner = nullptr;
+		ReferencerType* _inner = nullptr;
 	};
 }
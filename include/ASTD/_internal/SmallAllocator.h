@@ -0,0 +1,399 @@
+// Copyright Alternity Arts. All Rights Reserved
+
+#pragma once
+
+// Included by Memory.h after platform memory
+#include "ASTD/Build.h"
+#include "ASTD/Check.h"
+
+// TODO: Replace with custom implementation
+#include <mutex>
+#include <new>
+
+namespace _NMemory
+{
+	static constexpr int32 SMALL_CLASS_NUM = 23;
+	static constexpr int32 SMALL_MAX_BLOCK_SIZE = 2048;
+
+	// Block sizes of small allocator including header
+	inline constexpr int32 SMALL_CLASS_SIZES[SMALL_CLASS_NUM] = {
+		32, 48, 64, 80, 96, 112, 128,
+		160, 192, 224, 256,
+		320, 384, 448, 512,
+		640, 768, 896, 1024,
+		1280, 1536, 1792, 2048
+	};
+
+	// Maps block size divided by 16 to size class
+	struct SSmallClassTable
+	{
+		constexpr SSmallClassTable()
+			: Index()
+		{
+			int32 classIdx = 0;
+			for (int32 i = 0; i <= SMALL_MAX_BLOCK_SIZE / 16; ++i)
+			{
+				while (SMALL_CLASS_SIZES[classIdx] < i * 16)
+				{
+					++classIdx;
+				}
+
+				Index[i] = (uint8)classIdx;
+			}
+		}
+
+		uint8 Index[SMALL_MAX_BLOCK_SIZE / 16 + 1];
+	};
+
+	inline constexpr SSmallClassTable SMALL_CLASS_TABLE = {};
+
+	// Allocator of small objects used by SMemory when ASTD_SMALL_ALLOCATOR is enabled
+	// * Requests up to MAX_SMALL_SIZE are rounded to size class and served from per-thread free lists without locking
+	// * Thread caches are refilled from and returned to central lists in batches, so locks are taken once per batch
+	// * Memory freed on other thread goes to cache of that thread and flows back through central lists
+	// * Bigger requests go directly to platform allocator
+	// * Every allocation starts with 16 byte header, spans of small blocks are never given back to the system
+	struct SSmallAllocator
+	{
+		typedef PLATFORM_PREFIXED_TYPE(S, PlatformMemory) PlatformMemoryType;
+
+		static constexpr int64 HEADER_SIZE = 16;
+		static constexpr int64 MAX_BLOCK_SIZE = SMALL_MAX_BLOCK_SIZE;
+		static constexpr int64 MAX_SMALL_SIZE = MAX_BLOCK_SIZE - HEADER_SIZE;
+		static constexpr int64 SPAN_SIZE = 64 << 10; // 64 KiB
+
+		// Allocation
+		/////////////////////////////////
+
+		static void* Malloc(int64 size)
+		{
+			if (size > MAX_SMALL_SIZE)
+			{
+				SHeader* header = (SHeader*)PlatformMemoryType::Malloc(size + HEADER_SIZE);
+				if (!header) return nullptr;
+
+				header->Magic = MAGIC;
+				header->ClassIdx = LARGE_CLASS;
+				header->Size = size;
+				return (uint8*)header + HEADER_SIZE;
+			}
+
+			const uint32 classIdx = GetClassIdxImpl(size);
+
+			SHeader* header = (SHeader*)PopImpl(classIdx);
+			if (!header) return nullptr;
+
+			header->Magic = MAGIC;
+			header->ClassIdx = classIdx;
+			header->Size = size;
+			return (uint8*)header + HEADER_SIZE;
+		}
+
+		static void* Calloc(int64 size)
+		{
+			void* ptr = Malloc(size);
+			if (ptr)
+			{
+				PlatformMemoryType::Zero(ptr, size);
+			}
+
+			return ptr;
+		}
+
+		static void* Realloc(void* ptr, int64 size)
+		{
+			if (!ptr) return Malloc(size);
+
+			SHeader* header = GetHeaderImpl(ptr);
+			if (!header) return nullptr;
+
+			if (header->ClassIdx == LARGE_CLASS && size > MAX_SMALL_SIZE)
+			{
+				// Platform can often grow large block in place
+				header = (SHeader*)PlatformMemoryType::Realloc(header, size + HEADER_SIZE);
+				if (!header) return nullptr;
+
+				header->Size = size;
+				return (uint8*)header + HEADER_SIZE;
+			}
+			else if (header->ClassIdx != LARGE_CLASS && size + HEADER_SIZE <= SMALL_CLASS_SIZES[header->ClassIdx])
+			{
+				// Still fits into the same block
+				header->Size = size;
+				return ptr;
+			}
+
+			void* newPtr = Malloc(size);
+			if (newPtr)
+			{
+				PlatformMemoryType::Copy(newPtr, ptr, header->Size < size ? header->Size : size);
+				Free(ptr);
+			}
+
+			return newPtr;
+		}
+
+		static void Free(void* ptr)
+		{
+			if (!ptr) return;
+
+			SHeader* header = GetHeaderImpl(ptr);
+			if (!header) return;
+
+			if (header->ClassIdx == LARGE_CLASS)
+			{
+				header->Magic = 0;
+				PlatformMemoryType::Free(header);
+				return;
+			}
+
+			PushImpl(header->ClassIdx, header);
+		}
+
+		// Gets size requested by allocation
+		FORCEINLINE static int64 GetAllocationSize(const void* ptr)
+		{
+			const SHeader* header = ptr ? GetHeaderImpl(ptr) : nullptr;
+			return header ? header->Size : 0;
+		}
+
+	private:
+
+		static constexpr uint32 MAGIC = 0xA57DA110;
+		static constexpr uint32 LARGE_CLASS = 0xFF;
+		static constexpr int32 CLASS_NUM = SMALL_CLASS_NUM;
+
+		struct SHeader
+		{
+			uint32 Magic;
+			uint32 ClassIdx;
+			int64 Size;
+		};
+
+		static_assert(sizeof(SHeader) == HEADER_SIZE, "Header has to keep 16 byte alignment of allocations");
+
+		struct SFreeBlock
+		{
+			SFreeBlock* Next;
+		};
+
+		struct SCacheBin
+		{
+			SFreeBlock* Head;
+			int32 Num;
+		};
+
+		// Plain data, so it stays usable while other thread_local objects are destroyed
+		struct SThreadCache
+		{
+			SCacheBin Bins[CLASS_NUM];
+			bool IsDisabled;
+		};
+
+		// Returns cached blocks to central lists when thread exits
+		struct SThreadCacheFlusher
+		{
+			FORCEINLINE SThreadCacheFlusher(SThreadCache& cache) : _cache(cache) {}
+
+			~SThreadCacheFlusher()
+			{
+				_cache.IsDisabled = true;
+				for (int32 i = 0; i < CLASS_NUM; ++i)
+				{
+					SCacheBin& bin = _cache.Bins[i];
+					if (bin.Num > 0)
+					{
+						FlushImpl(i, bin, bin.Num);
+					}
+				}
+			}
+
+			SThreadCache& _cache;
+		};
+
+		struct SCentralBin
+		{
+			std::mutex Mutex;
+			SFreeBlock* Head = nullptr;
+		};
+
+		FORCEINLINE static uint32 GetClassIdxImpl(int64 size)
+		{
+			return SMALL_CLASS_TABLE.Index[((size > 0 ? size : 0) + HEADER_SIZE + 15) >> 4];
+		}
+
+		FORCEINLINE static SHeader* GetHeaderImpl(const void* ptr)
+		{
+			// Pointer not allocated here (or freed twice) is never put into free lists
+			SHeader* header = (SHeader*)((uint8*)ptr - HEADER_SIZE);
+			CHECK_RET(header->Magic == MAGIC, nullptr);
+			return header;
+		}
+
+		// Blocks moved between thread cache and central list at once
+		FORCEINLINE static int32 GetBatchNumImpl(uint32 classIdx)
+		{
+			const int32 num = 8192 / SMALL_CLASS_SIZES[classIdx];
+			return num < 4 ? 4 : (num > 64 ? 64 : num);
+		}
+
+		FORCEINLINE static SThreadCache& GetCacheImpl()
+		{
+			thread_local SThreadCache cache = {};
+			thread_local SThreadCacheFlusher flusher(cache);
+			return cache;
+		}
+
+		// Central lists are never destroyed, so blocks can be freed even during static destruction
+		static SCentralBin* GetCentralImpl()
+		{
+			alignas(SCentralBin) static uint8 storage[sizeof(SCentralBin) * CLASS_NUM];
+			static SCentralBin* bins = []()
+			{
+				SCentralBin* result = (SCentralBin*)storage;
+				for (int32 i = 0; i < CLASS_NUM; ++i)
+				{
+					::new((void*)(result + i)) SCentralBin();
+				}
+
+				return result;
+			}();
+
+			return bins;
+		}
+
+		FORCEINLINE static void* PopImpl(uint32 classIdx)
+		{
+			SThreadCache& cache = GetCacheImpl();
+			if (cache.IsDisabled)
+			{
+				// Thread is exiting, bypasses the cache
+				SCacheBin bin = {};
+				RefillImpl(classIdx, bin, 1);
+				return PopFromBinImpl(bin);
+			}
+
+			SCacheBin& bin = cache.Bins[classIdx];
+			if (!bin.Head)
+			{
+				RefillImpl(classIdx, bin, GetBatchNumImpl(classIdx));
+			}
+
+			return PopFromBinImpl(bin);
+		}
+
+		FORCEINLINE static void PushImpl(uint32 classIdx, void* ptr)
+		{
+			SFreeBlock* block = (SFreeBlock*)ptr;
+
+			SThreadCache& cache = GetCacheImpl();
+			if (cache.IsDisabled)
+			{
+				SCacheBin bin = { block, 1 };
+				block->Next = nullptr;
+				FlushImpl(classIdx, bin, 1);
+				return;
+			}
+
+			SCacheBin& bin = cache.Bins[classIdx];
+			block->Next = bin.Head;
+			bin.Head = block;
+			++bin.Num;
+
+			const int32 batchNum = GetBatchNumImpl(classIdx);
+			if (bin.Num > batchNum * 2)
+			{
+				FlushImpl(classIdx, bin, batchNum);
+			}
+		}
+
+		FORCEINLINE static void* PopFromBinImpl(SCacheBin& bin)
+		{
+			SFreeBlock* block = bin.Head;
+			if (block)
+			{
+				bin.Head = block->Next;
+				--bin.Num;
+			}
+
+			return block;
+		}
+
+		// Moves "num" blocks from central list (or new span) into the bin
+		static void RefillImpl(uint32 classIdx, SCacheBin& bin, int32 num)
+		{
+			SCentralBin& central = GetCentralImpl()[classIdx];
+			{
+				std::lock_guard<std::mutex> lock(central.Mutex);
+				while (central.Head && num > 0)
+				{
+					SFreeBlock* block = central.Head;
+					central.Head = block->Next;
+
+					block->Next = bin.Head;
+					bin.Head = block;
+					++bin.Num;
+					--num;
+				}
+			}
+
+			if (num == 0 || bin.Head)
+			{
+				return;
+			}
+
+			// Central list is empty, carves new span
+			uint8* span = (uint8*)PlatformMemoryType::Malloc(SPAN_SIZE);
+			if (!span) return;
+
+			const int64 blockSize = SMALL_CLASS_SIZES[classIdx];
+			const int64 blocksNum = SPAN_SIZE / blockSize;
+
+			SFreeBlock* rest = nullptr;
+			for (int64 i = blocksNum - 1; i >= 0; --i)
+			{
+				SFreeBlock* block = (SFreeBlock*)(span + i * blockSize);
+				if (i < num)
+				{
+					block->Next = bin.Head;
+					bin.Head = block;
+					++bin.Num;
+				}
+				else
+				{
+					block->Next = rest;
+					rest = block;
+				}
+			}
+
+			if (rest)
+			{
+				SFreeBlock* last = (SFreeBlock*)(span + (blocksNum - 1) * blockSize);
+
+				std::lock_guard<std::mutex> lock(central.Mutex);
+				last->Next = central.Head;
+				central.Head = rest;
+			}
+		}
+
+		// Moves "num" blocks from the bin to central list
+		static void FlushImpl(uint32 classIdx, SCacheBin& bin, int32 num)
+		{
+			SFreeBlock* first = bin.Head;
+			SFreeBlock* last = first;
+			for (int32 i = 1; i < num; ++i)
+			{
+				last = last->Next;
+			}
+
+			bin.Head = last->Next;
+			bin.Num -= num;
+
+			SCentralBin& central = GetCentralImpl()[classIdx];
+
+			std::lock_guard<std::mutex> lock(central.Mutex);
+			last->Next = central.Head;
+			central.Head = first;
+		}
+	};
+}
@@ -4,35 +4,63 @@
 
 #include <initializer_list>
 
+// ENUMS
+/////////////////////////////////
+
+// Thread safety of shared pointers. See Shared.h
+enum class ESPMode : uint8
+{
+	// Reference counts are plain integers, single object must not be shared between threads
+	NotThreadSafe = 0,
+	// Reference counts are atomic
+	ThreadSafe
+};
+
 // SIMPLE TYPES
 /////////////////////////////////
 
 struct SArchive;
-struct SString;
 
 // TEMPLATED TYPES
 /////////////////////////////////
 
-template<typename ElementT>
+template<typename ElementT, uint32 Alignment = 0>
 class TArrayAllocator;
 
 template<typename ElementT, typename AllocatorT = TArrayAllocator<ElementT>>
 class TArray;
 
 template<typename ElementT>
-class TOptional;
+class TArenaAllocator;
 
 template<typename ElementT>
+class TOptional;
+
+struct SQueueHeapMemory;
+
+template<typename ElementT, typename MemoryT = SQueueHeapMemory>
 class TQueueAllocator;
 
 template<typename ElementT, typename AllocatorT = TQueueAllocator<ElementT>>
 class TQueue;
 
-template<typename T>
+template<typename T, ESPMode Mode = ESPMode::ThreadSafe>
 class TSharedClass;
 
-template<typename T>
+template<typename T, ESPMode Mode = ESPMode::ThreadSafe>
 class TSharedPtr;
 
+template<typename T, ESPMode Mode = ESPMode::ThreadSafe>
+class TWeakPtr;
+
 template<typename T>
-class TWeakPtr;
\ No newline at end of file
+struct TDefaultDelete;
+
+template<typename T, typename DeleterT = TDefaultDelete<T>>
+class TUniquePtr;
+
+template<typename AllocatorT>
+struct TString;
+
+typedef TString<TArrayAllocator<tchar>> SString;
+typedef TString<TArenaAllocator<tchar>> SArenaString;
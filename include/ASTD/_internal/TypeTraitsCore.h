@@ -97,6 +97,13 @@ template<typename T> struct TIsArray { enum { Value = false }; };
 template<typename T> struct TIsArray<T[]> { enum { Value = true }; };
 template<typename T, uint32 N> struct TIsArray<T[N]> { enum { Value = true }; };
 
+// [Remove Extent]
+// * Removes array extent from provided type
+
+template<typename T> struct TRemoveExtent { typedef T Type; };
+template<typename T> struct TRemoveExtent<T[]> { typedef T Type; };
+template<typename T, uint32 N> struct TRemoveExtent<T[N]> { typedef T Type; };
+
 // [Is Function]
 // * Checks whether specific type is function
 